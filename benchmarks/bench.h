@@ -0,0 +1,24 @@
+#ifndef BENCHH
+#define BENCHH
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+static inline uint64_t bench_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Stops the compiler discarding work whose result is never read
+static inline void bench_consume(const void *ptr) {
+  __asm__ volatile("" : : "r"(ptr) : "memory");
+}
+
+static inline void bench_report(const char *name, uint64_t elapsed_ns, uint64_t iterations) {
+  printf("%-40s %10.2f ns/op  (%llu ops)\n", name, (double)elapsed_ns / (double)iterations, (unsigned long long)iterations);
+}
+
+#endif
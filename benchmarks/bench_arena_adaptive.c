@@ -0,0 +1,34 @@
+#include "bench.h"
+#include "../include/collections/arena.h"
+
+/*
+ * Per-request arenas that start from a poor size guess, reset after
+ * every request, with and without ARENA_ADAPTIVE.
+ */
+
+#define REQUESTS 200000
+#define ALLOCS_PER_REQUEST 256
+#define INITIAL_GUESS 1024
+
+static void bench(const char *name, int flags) {
+  c_arena_t *arena = arena_create_flags(INITIAL_GUESS, flags);
+  uint64_t start = bench_now_ns();
+  for (int r = 0; r < REQUESTS; r++) {
+    for (int i = 0; i < ALLOCS_PER_REQUEST; i++) {
+      char *block = arena_alloc(arena, 48 + (i & 7) * 16);
+      block[0] = (char)i;
+      bench_consume(block);
+    }
+    arena_reset(arena);
+  }
+  bench_report(name, bench_now_ns() - start, REQUESTS);
+  c_arena_stats_t stats = arena_stats(arena);
+  printf("  %zu nodes, %zu nodes created\n", stats.node_count, stats.grow_count);
+  arena_free(arena);
+}
+
+int main(void) {
+  bench("fixed chain per request", ARENA_GROWABLE);
+  bench("ARENA_ADAPTIVE per request", ARENA_GROWABLE | ARENA_ADAPTIVE);
+  return 0;
+}
@@ -0,0 +1,57 @@
+#include "bench.h"
+#include "../include/collections/arena.h"
+
+/*
+ * Allocates a parse tree node with its children array and payload,
+ * as three separate allocations and as one arena_alloc_many batch.
+ */
+
+#define NODES 10000000
+#define ARENA_SIZE ((size_t)1024 * 1024)
+
+typedef struct node {
+  struct node **children;
+  char *payload;
+  size_t child_count;
+} node;
+
+static node *make_separate(c_arena_t *arena, size_t child_count, size_t payload_size) {
+  node *n = arena_alloc_aligned(arena, sizeof(node), alignof(node));
+  n->children = arena_alloc_array(arena, child_count, sizeof(node *), alignof(node *));
+  n->payload = arena_alloc_aligned(arena, payload_size, 1);
+  n->child_count = child_count;
+  return n;
+}
+
+static node *make_batched(c_arena_t *arena, size_t child_count, size_t payload_size) {
+  c_arena_block_t blocks[] = {
+    { .size = sizeof(node), .align = alignof(node) },
+    { .size = child_count * sizeof(node *), .align = alignof(node *) },
+    { .size = payload_size, .align = 1 },
+  };
+  arena_alloc_many(arena, blocks, 3);
+  node *n = blocks[0].ptr;
+  n->children = blocks[1].ptr;
+  n->payload = blocks[2].ptr;
+  n->child_count = child_count;
+  return n;
+}
+
+static void bench(const char *name, node *(*make)(c_arena_t *, size_t, size_t)) {
+  c_arena_t *arena = arena_create_flags(ARENA_SIZE, ARENA_GROWABLE);
+  uint64_t start = bench_now_ns();
+  for (int i = 0; i < NODES; i++) {
+    // Reuses the same memory so only the allocation path is measured
+    if ((i & 1023) == 0) arena_reset(arena);
+    node *n = make(arena, (size_t)(i & 3), (size_t)(8 + (i & 15)));
+    bench_consume(n);
+  }
+  bench_report(name, bench_now_ns() - start, NODES);
+  arena_free(arena);
+}
+
+int main(void) {
+  bench("three allocations per node", make_separate);
+  bench("arena_alloc_many per node", make_batched);
+  return 0;
+}
@@ -0,0 +1,46 @@
+#include "bench.h"
+#include "../include/collections/arena.h"
+
+#include <string.h>
+
+/*
+ * Random reads across one large arena allocation, with regular pages and
+ * with huge pages. The working set is far beyond what 4 KiB TLB entries
+ * cover, so the gap is mostly page walk cost.
+ */
+
+#define WORKING_SET ((size_t)512 * 1024 * 1024)
+#define ITERATIONS 20000000
+
+static void bench_random_access(const char *name, int flags) {
+  c_arena_t *arena = arena_create_flags(WORKING_SET, flags);
+  if (arena == NULL) {
+    printf("%-40s unavailable\n", name);
+    return;
+  }
+  uint64_t *words = arena_alloc(arena, WORKING_SET);
+  size_t count = WORKING_SET / sizeof(uint64_t);
+  // Fault everything in first so only access cost is measured
+  memset(words, 1, WORKING_SET);
+
+  uint64_t state = 88172645463325252ull;
+  uint64_t sum = 0;
+  uint64_t start = bench_now_ns();
+  for (int i = 0; i < ITERATIONS; i++) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    sum += words[state % count];
+  }
+  bench_report(name, bench_now_ns() - start, ITERATIONS);
+  bench_consume(&sum);
+
+  arena_free(arena);
+}
+
+int main(void) {
+  bench_random_access("random reads, regular pages", ARENA_NO_FLAGS);
+  bench_random_access("random reads, ARENA_HUGE_PAGES", ARENA_HUGE_PAGES);
+  bench_random_access("random reads, ARENA_HUGETLB", ARENA_HUGETLB);
+  return 0;
+}
@@ -0,0 +1,41 @@
+#include "bench.h"
+#include "../include/collections/arena.h"
+
+/*
+ * Compares reclaiming per-scope scratch memory with a fresh arena per
+ * scope against marking and rewinding one long-lived arena.
+ */
+
+#define SCOPES 1000000
+#define ALLOCS_PER_SCOPE 8
+#define ARENA_SIZE 4096
+
+static void scope_work(c_arena_t *arena) {
+  for (int i = 0; i < ALLOCS_PER_SCOPE; i++) {
+    char *block = arena_alloc(arena, 64 + i * 16);
+    block[0] = (char)i;
+    bench_consume(block);
+  }
+}
+
+int main(void) {
+  uint64_t start = bench_now_ns();
+  for (int i = 0; i < SCOPES; i++) {
+    c_arena_t *arena = arena_create_flags(ARENA_SIZE, ARENA_GROWABLE);
+    scope_work(arena);
+    arena_free(arena);
+  }
+  bench_report("create/free per scope", bench_now_ns() - start, SCOPES);
+
+  c_arena_t *arena = arena_create_flags(ARENA_SIZE, ARENA_GROWABLE);
+  start = bench_now_ns();
+  for (int i = 0; i < SCOPES; i++) {
+    c_arena_mark_t mark = arena_mark(arena);
+    scope_work(arena);
+    arena_rewind(arena, mark);
+  }
+  bench_report("mark/rewind per scope", bench_now_ns() - start, SCOPES);
+  arena_free(arena);
+
+  return 0;
+}
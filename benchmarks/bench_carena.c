@@ -0,0 +1,94 @@
+#include "bench.h"
+#include "../include/collections/carena.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/*
+ * Scaling of a concurrent arena from 1 to N threads, each building a
+ * linked list of small nodes in the shared arena, against malloc.
+ */
+
+#define NODES_PER_THREAD 2000000
+#define CHUNK_SIZE (64 * 1024)
+
+typedef struct node {
+  struct node *next;
+  uint64_t value;
+} node;
+
+typedef struct {
+  c_carena_t *arena;
+  node *head;
+} worker_t;
+
+static void *carena_worker(void *arg) {
+  worker_t *w = (worker_t *)arg;
+  c_carena_lease_t lease = carena_lease_init(w->arena);
+  node *head = NULL;
+  for (uint64_t i = 0; i < NODES_PER_THREAD; i++) {
+    node *n = carena_alloc(&lease, sizeof(node), alignof(node));
+    n->value = i;
+    n->next = head;
+    head = n;
+  }
+  w->head = head;
+  return NULL;
+}
+
+static void *malloc_worker(void *arg) {
+  worker_t *w = (worker_t *)arg;
+  node *head = NULL;
+  for (uint64_t i = 0; i < NODES_PER_THREAD; i++) {
+    node *n = malloc(sizeof(node));
+    n->value = i;
+    n->next = head;
+    head = n;
+  }
+  w->head = head;
+  return NULL;
+}
+
+static void free_list(node *head) {
+  while (head != NULL) {
+    node *next = head->next;
+    free(head);
+    head = next;
+  }
+}
+
+int main(void) {
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  if (cores < 1) cores = 1;
+
+  worker_t *workers = calloc(cores, sizeof(worker_t));
+  pthread_t *threads = calloc(cores, sizeof(pthread_t));
+  char name[64];
+
+  // Doubles thread count, always finishing on the full core count
+  for (long n = 1; n <= cores; n = (n < cores && n * 2 > cores) ? cores : n * 2) {
+    c_carena_t *arena = carena_create((size_t)n * NODES_PER_THREAD * sizeof(node) * 2, CHUNK_SIZE);
+    uint64_t start = bench_now_ns();
+    for (long i = 0; i < n; i++) {
+      workers[i].arena = arena;
+      pthread_create(&threads[i], NULL, carena_worker, &workers[i]);
+    }
+    for (long i = 0; i < n; i++) pthread_join(threads[i], NULL);
+    snprintf(name, sizeof(name), "carena alloc, %ld threads", n);
+    bench_report(name, bench_now_ns() - start, (uint64_t)n * NODES_PER_THREAD);
+    // The whole graph goes in one call
+    carena_free(arena);
+
+    start = bench_now_ns();
+    for (long i = 0; i < n; i++) pthread_create(&threads[i], NULL, malloc_worker, &workers[i]);
+    for (long i = 0; i < n; i++) pthread_join(threads[i], NULL);
+    snprintf(name, sizeof(name), "malloc, %ld threads", n);
+    bench_report(name, bench_now_ns() - start, (uint64_t)n * NODES_PER_THREAD);
+    for (long i = 0; i < n; i++) free_list(workers[i].head);
+  }
+
+  free(threads);
+  free(workers);
+  return 0;
+}
@@ -0,0 +1,85 @@
+#include "bench.h"
+#include "../include/collections/vector.h"
+#include "../include/collections/parray.h"
+
+#include <stdlib.h>
+
+/*
+ * Appends to a vector and a pointer array under each growth policy,
+ * counting reallocations and the bytes they had to carry over through
+ * an allocator that wraps the C library.
+ */
+
+#define ELEMENTS 10000000
+
+typedef struct {
+  size_t reallocs;
+  size_t bytes_copied;
+} realloc_counter;
+
+static void *counting_alloc(void *ctx, size_t size) {
+  (void)ctx;
+  return malloc(size);
+}
+
+static void *counting_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size) {
+  realloc_counter *counter = (realloc_counter *)ctx;
+  counter->reallocs++;
+  // Upper bound, realloc may extend in place
+  counter->bytes_copied += old_size;
+  return realloc(ptr, new_size);
+}
+
+static void counting_free(void *ctx, void *ptr, size_t size) {
+  (void)ctx;
+  (void)size;
+  free(ptr);
+}
+
+// Grows in large fixed chunks, as a custom callback
+static size_t grow_linear(size_t capacity, size_t required, void *ctx) {
+  (void)required;
+  (void)ctx;
+  return capacity + 1024 * 1024;
+}
+
+static void report(const char *container, const char *policy, uint64_t ns, const realloc_counter *counter) {
+  char name[64];
+  snprintf(name, sizeof(name), "%s, %s", container, policy);
+  bench_report(name, ns, ELEMENTS);
+  printf("  %zu reallocs, %zu MiB carried over\n", counter->reallocs, counter->bytes_copied >> 20);
+}
+
+static void bench_policy(const char *policy_name, c_growth_policy_t policy) {
+  realloc_counter counter = {0};
+  c_allocator_t allocator = {
+    .alloc = counting_alloc,
+    .realloc = counting_realloc,
+    .free = counting_free,
+    .ctx = &counter,
+  };
+
+  c_vector_t *v = vector_create_with_allocator(sizeof(uint64_t), &allocator);
+  vector_set_growth(v, policy);
+  uint64_t start = bench_now_ns();
+  for (uint64_t i = 0; i < ELEMENTS; i++) vector_push_back(v, &i);
+  report("vector", policy_name, bench_now_ns() - start, &counter);
+  vector_free(v);
+
+  counter = (realloc_counter){0};
+  c_parray_t *parray = parray_create_with_allocator(NULL, &allocator);
+  parray_set_growth(parray, policy);
+  start = bench_now_ns();
+  for (uint64_t i = 0; i < ELEMENTS; i++) parray_append(parray, (void *)(uintptr_t)i);
+  report("parray", policy_name, bench_now_ns() - start, &counter);
+  parray_free(parray);
+}
+
+int main(void) {
+  bench_policy("built-in ~1.125x", GROWTH_POLICY_DEFAULT);
+  bench_policy("factor 1.5", (c_growth_policy_t){ .factor = 1.5 });
+  bench_policy("factor 2", (c_growth_policy_t){ .factor = 2.0 });
+  bench_policy("min step 64Ki", (c_growth_policy_t){ .min_step = 64 * 1024 });
+  bench_policy("custom +1Mi", (c_growth_policy_t){ .custom = grow_linear });
+  return 0;
+}
@@ -0,0 +1,69 @@
+#include "bench.h"
+#include "../include/collections/pool.h"
+
+#include <stdlib.h>
+
+/*
+ * Churns a working set of fixed-size objects, releasing and reallocating
+ * one at random per iteration, through a pool and through malloc/free.
+ */
+
+#define LIVE_OBJECTS 4096
+#define ITERATIONS 10000000
+
+static void *live[LIVE_OBJECTS];
+
+// Cheap deterministic index generator, so both runs churn identically
+static uint32_t next_index(uint32_t *state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state % LIVE_OBJECTS;
+}
+
+static void bench_pool(size_t obj_size) {
+  c_arena_t *arena = arena_create_flags(64 * 1024, ARENA_GROWABLE);
+  c_pool_t *pool = pool_create(arena, obj_size);
+  for (int i = 0; i < LIVE_OBJECTS; i++) live[i] = pool_alloc(pool);
+
+  uint32_t state = 2463534242u;
+  uint64_t start = bench_now_ns();
+  for (int i = 0; i < ITERATIONS; i++) {
+    uint32_t index = next_index(&state);
+    pool_release(pool, live[index]);
+    live[index] = pool_alloc(pool);
+    *(char *)live[index] = (char)i;
+  }
+  char name[64];
+  snprintf(name, sizeof(name), "pool %zu bytes", obj_size);
+  bench_report(name, bench_now_ns() - start, ITERATIONS);
+
+  // No per-object frees needed
+  arena_free(arena);
+}
+
+static void bench_malloc(size_t obj_size) {
+  for (int i = 0; i < LIVE_OBJECTS; i++) live[i] = malloc(obj_size);
+
+  uint32_t state = 2463534242u;
+  uint64_t start = bench_now_ns();
+  for (int i = 0; i < ITERATIONS; i++) {
+    uint32_t index = next_index(&state);
+    free(live[index]);
+    live[index] = malloc(obj_size);
+    *(char *)live[index] = (char)i;
+  }
+  char name[64];
+  snprintf(name, sizeof(name), "malloc %zu bytes", obj_size);
+  bench_report(name, bench_now_ns() - start, ITERATIONS);
+
+  for (int i = 0; i < LIVE_OBJECTS; i++) free(live[i]);
+}
+
+int main(void) {
+  for (size_t obj_size = 16; obj_size <= 256; obj_size *= 2) {
+    bench_pool(obj_size);
+    bench_malloc(obj_size);
+  }
+  return 0;
+}
@@ -0,0 +1,55 @@
+#include "bench.h"
+#include "../include/collections/strintern.h"
+
+#include <stdlib.h>
+
+/*
+ * Interns a stream of repeated identifiers, as a parser would, compared
+ * with copying every occurrence with malloc.
+ */
+
+#define DISTINCT 10000
+#define OCCURRENCES 5000000
+
+static char names[DISTINCT][32];
+static size_t lengths[DISTINCT];
+static char *copies[OCCURRENCES];
+
+// Cheap deterministic index generator, so both runs see the same stream
+static uint32_t next_index(uint32_t *state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state % DISTINCT;
+}
+
+int main(void) {
+  for (int i = 0; i < DISTINCT; i++) {
+    lengths[i] = (size_t)snprintf(names[i], sizeof(names[i]), "ident_%d", i * 7919);
+  }
+
+  c_arena_t *arena = arena_create_flags(64 * 1024, ARENA_GROWABLE);
+  c_strintern_t *interner = strintern_create(arena);
+  uint32_t state = 2463534242u;
+  uint64_t start = bench_now_ns();
+  for (int i = 0; i < OCCURRENCES; i++) {
+    uint32_t index = next_index(&state);
+    uint32_t id = strintern_intern(interner, names[index], lengths[index]);
+    bench_consume(&id);
+  }
+  bench_report("strintern_intern", bench_now_ns() - start, OCCURRENCES);
+  strintern_free(interner);
+  arena_free(arena);
+
+  state = 2463534242u;
+  start = bench_now_ns();
+  for (int i = 0; i < OCCURRENCES; i++) {
+    uint32_t index = next_index(&state);
+    copies[i] = malloc(lengths[index] + 1);
+    memcpy(copies[i], names[index], lengths[index] + 1);
+  }
+  bench_report("malloc copy per occurrence", bench_now_ns() - start, OCCURRENCES);
+  for (int i = 0; i < OCCURRENCES; i++) free(copies[i]);
+
+  return 0;
+}
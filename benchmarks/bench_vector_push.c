@@ -0,0 +1,44 @@
+#include "bench.h"
+#include "../include/collections/vector.h"
+
+/*
+ * Appends to a c_vector_t through the inline vector_push_back fast path,
+ * and through vector_insert at the end, the route push_back used to take.
+ * The vector is emptied and refilled, so only the append path is measured
+ * rather than reallocations and page faults.
+ */
+
+#define ROUNDS 100
+#define BATCH 200000
+
+typedef struct {
+  uint64_t id;
+  uint32_t flags;
+  uint32_t length;
+} record;
+
+static void bench(const char *name, bool insert) {
+  c_vector_t *v = vector_create(sizeof(record));
+  vector_reserve(v, BATCH);
+  uint64_t start = bench_now_ns();
+  for (int round = 0; round < ROUNDS; round++) {
+    vector_erase_range(v, 0, vector_size(v));
+    for (uint32_t i = 0; i < BATCH; i++) {
+      record r = { .id = i, .flags = 1, .length = i };
+      if (insert) {
+        vector_insert(v, vector_size(v), &r);
+      } else {
+        vector_push_back(v, &r);
+      }
+    }
+    bench_consume(vector_data(v));
+  }
+  bench_report(name, bench_now_ns() - start, (uint64_t)ROUNDS * BATCH);
+  vector_free(v);
+}
+
+int main(void) {
+  bench("vector_insert at end", true);
+  bench("vector_push_back", false);
+  return 0;
+}
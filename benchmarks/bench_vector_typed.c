@@ -0,0 +1,54 @@
+#include "bench.h"
+#include "../include/collections/typed_vector.h"
+
+/*
+ * Push and get throughput of int32_t elements, through the generic
+ * c_vector_t and through a VECTOR_DECLARE typed vector.
+ */
+
+#define ELEMENTS 10000000
+
+VECTOR_DECLARE(int32_t, i32)
+
+static void bench_generic(void) {
+  c_vector_t *v = vector_create(sizeof(int32_t));
+  uint64_t start = bench_now_ns();
+  for (int32_t i = 0; i < ELEMENTS; i++) vector_push_back(v, &i);
+  bench_report("generic push", bench_now_ns() - start, ELEMENTS);
+
+  int64_t sum = 0;
+  start = bench_now_ns();
+  for (size_t i = 0; i < ELEMENTS; i++) {
+    int32_t value = 0;
+    vector_get(v, i, &value);
+    sum += value;
+  }
+  bench_report("generic get", bench_now_ns() - start, ELEMENTS);
+  bench_consume(&sum);
+  vector_free(v);
+}
+
+static void bench_typed(void) {
+  c_vector_i32_t v;
+  vector_i32_init(&v, NULL);
+  uint64_t start = bench_now_ns();
+  for (int32_t i = 0; i < ELEMENTS; i++) vector_i32_push(&v, i);
+  bench_report("typed push", bench_now_ns() - start, ELEMENTS);
+
+  int64_t sum = 0;
+  start = bench_now_ns();
+  for (size_t i = 0; i < ELEMENTS; i++) {
+    int32_t value = 0;
+    vector_i32_get(&v, i, &value);
+    sum += value;
+  }
+  bench_report("typed get", bench_now_ns() - start, ELEMENTS);
+  bench_consume(&sum);
+  vector_i32_free(&v);
+}
+
+int main(void) {
+  bench_generic();
+  bench_typed();
+  return 0;
+}
@@ -0,0 +1,30 @@
+#ifndef ALLOCATORH
+#define ALLOCATORH
+
+#include <stddef.h>
+
+/**
+ * @brief Allocator interface
+ *
+ * Lets collections allocate their memory from something other than the
+ * C library, such as an arena, a size-class allocator or a custom allocator.
+ * Sizes are passed back on realloc and free, so allocators needn't track them.
+ */
+typedef struct {
+  void *(*alloc)(void *ctx, size_t size);
+  void *(*realloc)(void *ctx, void *ptr, size_t old_size, size_t new_size);
+  void (*free)(void *ctx, void *ptr, size_t size);
+  void *ctx;
+} c_allocator_t;
+
+/**
+ *
+ * @brief Retrieves the default allocator.
+ *
+ * Allocates with the C library's `malloc`, `realloc` and `free`.
+ *
+ * @return The default allocator.
+ */
+c_allocator_t allocator_default(void);
+
+#endif
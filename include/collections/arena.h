@@ -8,14 +8,124 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdalign.h>
+#include "allocator.h"
 
 #define ARENA_NO_FLAGS 0
 #define ARENA_DEFAULT_FLAGS ARENA_NO_FLAGS
 #define ARENA_GROWABLE 0b1
 #define ARENA_PRINT_DEBUG 0b10
 #define ARENA_EXIT_ON_ERROR 0b100
+#define ARENA_VIRTUAL 0b1000
+#define ARENA_HUGE_PAGES 0b10000
+#define ARENA_HUGETLB 0b100000
+#define ARENA_RELOCATABLE 0b1000000
+#define ARENA_ADAPTIVE 0b10000000
+
+#define ARENA_RETAIN_DECAYED SIZE_MAX
 
 typedef struct arena_t c_arena_t;
+typedef struct arena_image_t c_arena_image_t;
+
+/**
+ * @brief A self-relative pointer, see `relptr_set` and `relptr_get`.
+ *
+ * Stores the distance from itself to its target, so structures built from
+ * them stay valid wherever their memory is mapped.
+ */
+typedef int64_t c_relptr_t;
+
+/**
+ * @brief A savepoint within an arena, created by `arena_mark`.
+ *
+ * Fields are internal to the arena, do not modify them.
+ */
+typedef struct {
+  void *node;
+  void *pos;
+  size_t used;
+  void *large;
+  void *defers;
+} c_arena_mark_t;
+
+/**
+ * @brief One block of a batch allocation, see `arena_alloc_many`.
+ */
+typedef struct {
+  size_t size;  /**< Number of bytes requested. */
+  size_t align; /**< Alignment requested, a power of 2. */
+  void *ptr;    /**< Set to the block's memory on success, NULL on failure. */
+} c_arena_block_t;
+
+/**
+ * @brief How a growable arena sizes the memory nodes it grows into.
+ */
+typedef struct {
+  double factor;          /**< Each new node is the previous node's size times this, at least 1. */
+  size_t min_node_size;   /**< Smallest size of a new node. */
+  size_t max_node_size;   /**< Largest size of a new node, 0 for unbounded. */
+  size_t large_threshold; /**< Requests above this get a dedicated node, 0 to use the next node's size. */
+} c_arena_growth_t;
+
+/**
+ * @brief Snapshot of an arena's statistics, from `arena_stats`.
+ *
+ * Byte counts describe the arena as it is now, apart from `high_water`.
+ * Counters are totals over the arena's lifetime, unaffected by resets.
+ */
+typedef struct {
+  size_t node_count;  /**< Memory nodes held, including dedicated ones. */
+  size_t reserved;    /**< Bytes of address space held. */
+  size_t committed;   /**< Bytes backed by memory, below `reserved` only for virtual arenas. */
+  size_t used;        /**< Bytes handed out since the last reset, including padding and stranded bytes. */
+  size_t high_water;  /**< Most bytes ever used at once. */
+  size_t padding;     /**< Counter of bytes lost to alignment padding. */
+  size_t stranded;    /**< Counter of bytes left unused at node tails when moving to the next node. */
+  size_t alloc_count; /**< Counter of successful allocations. */
+  size_t grow_count;  /**< Counter of memory nodes created after the first. */
+} c_arena_stats_t;
+
+/**
+ * @brief Kinds of events reported to an arena's hook.
+ */
+typedef enum {
+  ARENA_EVENT_CREATE, /**< `size` is the initial capacity, `ptr` the first node. */
+  ARENA_EVENT_ALLOC,  /**< `size` and `align` are the request, `ptr` the result or NULL on failure. */
+  ARENA_EVENT_GROW,   /**< `size` is the new node's capacity, `ptr` its memory. */
+  ARENA_EVENT_RESET,  /**< `size` is the arena's capacity. */
+  ARENA_EVENT_REWIND, /**< `size` is the bytes still used, `ptr` the position rewound to. */
+  ARENA_EVENT_FREE,   /**< `size` is the arena's capacity. */
+} c_arena_event_kind_t;
+
+/**
+ * @brief An event reported to an arena's hook.
+ */
+typedef struct {
+  c_arena_event_kind_t kind;
+  size_t size;
+  size_t align;
+  void *ptr;
+} c_arena_event_t;
+
+/**
+ * @brief Callback receiving an arena's events, see `arena_set_hook`.
+ */
+typedef void (*c_arena_hook_t)(c_arena_t *arena, const c_arena_event_t *event, void *ctx);
+
+/**
+ * @brief Cleanup callback registered with `arena_defer`.
+ */
+typedef void (*c_arena_defer_t)(void *ctx);
+
+#define ARENA_DEFAULT_GROWTH ((c_arena_growth_t){ .factor = 2.0, .min_node_size = 0, .max_node_size = 0, .large_threshold = 0 })
+
+/**
+ * @brief What `arena_reset` does with the memory it reclaims.
+ */
+typedef enum {
+  ARENA_RESET_KEEP,      /**< Leave memory untouched. Default for heap arenas. */
+  ARENA_RESET_ZERO_USED, /**< Zero only the bytes used since the last reset. */
+  ARENA_RESET_RELEASE,   /**< Return whole pages to the OS. Default for virtual arenas. */
+} c_arena_reset_policy_t;
 
 /**
  *
@@ -36,17 +146,72 @@ c_arena_t *arena_create(size_t size);
  *
  * This arena is used for grouping memory lifetimes and simplifying heap memory management.
  *
- * @param size Number of bytes to allocate.
+ * With `ARENA_VIRTUAL`, `size` bytes of address space are reserved up front
+ * and pages are committed on demand as the arena fills, giving one
+ * contiguous region that never hops between memory nodes.
+ *
+ * With `ARENA_HUGE_PAGES`, every node is mapped 2 MiB aligned, rounded up to
+ * whole 2 MiB pages and advised for transparent huge pages, cutting TLB
+ * misses on large arenas. `ARENA_HUGETLB` first tries pages reserved with the
+ * kernel (`MAP_HUGETLB`) and falls back to transparent huge pages when none
+ * are available. Virtual arenas commit pages on demand, which reserved huge
+ * pages can't do, so with `ARENA_VIRTUAL` both flags give transparent huge
+ * pages only.
+ *
+ * With `ARENA_ADAPTIVE`, every `arena_reset` sizes the arena from the usage
+ * of recent cycles, as `arena_reset_retain` with `ARENA_RETAIN_DECAYED` does.
+ * A growable arena that chained nodes is coalesced into a single node the
+ * next cycle fits in, so a guessed initial size settles after one cycle.
+ * Requests served by dedicated nodes count toward that node's size too.
+ *
+ * `ARENA_RELOCATABLE` implies `ARENA_VIRTUAL`, keeping everything in one
+ * region that `arena_save` can write out as a single image.
+ *
+ * @param size Number of bytes to allocate (or reserve with `ARENA_VIRTUAL`).
  * @param flags Various options for the behaviour of the arena.
  * @return Pointer to arena, or NULL on failure.
+ *
+ * @note `ARENA_GROWABLE` has no effect on a virtual arena, it fails once
+ *       its reservation is exhausted.
  */
 c_arena_t *arena_create_flags(size_t size, int flags);
 
+/*
+ * Bump pointer state of an arena, read by the inline allocation fast path.
+ * It is the first member of every arena. Do not touch it directly.
+ */
+struct arena_bump {
+  char *pos; // 8
+  char *end; // 8
+  size_t allocs; // 8
+  size_t padding; // 8
+};
+
+/**
+ *
+ * @brief Slow path of `arena_alloc_aligned`.
+ *
+ * Handles everything the inline fast path cannot, moving to the next
+ * memory node, growing the arena, and reporting errors.
+ *
+ * @note Internal, call `arena_alloc_aligned` instead.
+ */
+void *arena_alloc_slow(c_arena_t *arena, size_t size, size_t align);
+
+/**
+ *
+ * @brief Slow path of `arena_alloc_many`.
+ *
+ * @note Internal, call `arena_alloc_many` instead.
+ */
+int arena_alloc_many_slow(c_arena_t *arena, c_arena_block_t *blocks, size_t count);
+
 /**
  *
  * @brief Allocates a new aligned block of memory from an arena allocator.
  *
  * This takes a block of memory from the arena.
+ * When the current memory node has room, this is an inline align-and-bump.
  *
  * @param arena Pointer to the arena allocator.
  * @param size Number of bytes to allocate.
@@ -56,7 +221,19 @@ c_arena_t *arena_create_flags(size_t size, int flags);
  * @note The lifetime of the returned memory is tied to the arena.
  *       Do not free() it manually.
  */
-void *arena_alloc_aligned(c_arena_t *arena, size_t size, size_t align);
+inline void *arena_alloc_aligned(c_arena_t *arena, size_t size, size_t align) {
+  struct arena_bump *bump = (struct arena_bump *)arena;
+  uintptr_t aligned = ((uintptr_t)bump->pos + align - 1) & ~(uintptr_t)(align - 1);
+  // The alignment checks fold away for constant alignments
+  if (align != 0 && (align & (align - 1)) == 0
+      && aligned <= (uintptr_t)bump->end && size <= (uintptr_t)bump->end - aligned) {
+    bump->allocs++;
+    bump->padding += aligned - (uintptr_t)bump->pos;
+    bump->pos = (char *)aligned + size;
+    return (void *)aligned;
+  }
+  return arena_alloc_slow(arena, size, align);
+}
 
 /**
  *
@@ -73,13 +250,104 @@ void *arena_alloc_aligned(c_arena_t *arena, size_t size, size_t align);
  *       to be out of memory earlier than expected,
  *       particularly for smaller arenas.
  */
-void *arena_alloc(c_arena_t *arena, size_t size);
+inline void *arena_alloc(c_arena_t *arena, size_t size) {
+  return arena_alloc_aligned(arena, size, alignof(max_align_t));
+}
+
+/**
+ *
+ * @brief Allocates an aligned array from an arena allocator.
+ *
+ * Like `arena_alloc_aligned` for `count * elem_size` bytes,
+ * but fails instead of wrapping around when the product overflows.
+ *
+ * @param arena Pointer to the arena allocator.
+ * @param count Number of elements.
+ * @param elem_size Size of each element in bytes.
+ * @param align The alignment of the memory.
+ * @return Pointer to the array, or `nullptr` on overflow or error.
+ */
+inline void *arena_alloc_array(c_arena_t *arena, size_t count, size_t elem_size, size_t align) {
+  if (elem_size != 0 && count > SIZE_MAX / elem_size) return NULL;
+  return arena_alloc_aligned(arena, count * elem_size, align);
+}
+
+/**
+ *
+ * @brief Allocates several differently sized blocks from an arena in one go.
+ *
+ * The blocks are laid out back to back in order, each at its own alignment,
+ * and carved from a single allocation with a single capacity check.
+ * Allocating a node together with its children and payload this way keeps
+ * them adjacent in memory.
+ *
+ * @param arena Pointer to the arena allocator.
+ * @param blocks Blocks to allocate, each `ptr` is set on success.
+ * @param count Number of blocks.
+ * @return 0 on success, -1 on invalid alignment, overflow or error,
+ *         in which case nothing is allocated and every `ptr` is NULL.
+ */
+inline int arena_alloc_many(c_arena_t *arena, c_arena_block_t *blocks, size_t count) {
+  if (count == 0) return 0;
+  struct arena_bump *bump = (struct arena_bump *)arena;
+  uintptr_t pos = (uintptr_t)bump->pos;
+  size_t requested = 0;
+  // Lays the blocks out straight from the current position, committing only if all fit
+  for (size_t i = 0; i < count; i++) {
+    size_t align = blocks[i].align;
+    uintptr_t aligned = (pos + align - 1) & ~(uintptr_t)(align - 1);
+    if (align == 0 || (align & (align - 1)) != 0
+        || aligned > (uintptr_t)bump->end || blocks[i].size > (uintptr_t)bump->end - aligned) {
+      return arena_alloc_many_slow(arena, blocks, count);
+    }
+    blocks[i].ptr = (void *)aligned;
+    pos = aligned + blocks[i].size;
+    requested += blocks[i].size;
+  }
+  bump->allocs++;
+  bump->padding += pos - (uintptr_t)bump->pos - requested;
+  bump->pos = (char *)pos;
+  return 0;
+}
+
+/**
+ *
+ * @brief Resizes a block of memory allocated from an arena.
+ *
+ * When `ptr` is the most recent allocation in the arena's current memory
+ * node, it grows or shrinks in place by moving the arena's position.
+ * Other blocks shrink in place without reclaiming anything, and grow by
+ * allocating a new block and copying the contents over.
+ *
+ * @param arena Pointer to the arena allocator.
+ * @param ptr The block to resize, or NULL to allocate a new one.
+ * @param old_size The size `ptr` was allocated or last resized with.
+ * @param new_size The size to resize to.
+ * @return Pointer to the resized block, or `nullptr` on error.
+ *
+ * @note When moved, the new block is aligned to `alignof(max_align_t)`.
+ *       The old block is left as is until the arena is reset.
+ */
+void *arena_realloc(c_arena_t *arena, void *ptr, size_t old_size, size_t new_size);
+
+/**
+ *
+ * @brief Creates an allocator interface backed by an arena.
+ *
+ * Lets collections live in the arena, so they are released with it.
+ * Reallocation uses `arena_realloc`, and freeing does nothing.
+ *
+ * @param arena Pointer to the arena allocator.
+ * @return An allocator allocating from `arena`.
+ */
+c_allocator_t arena_allocator(c_arena_t *arena);
 
 /**
  *
  * @brief Frees an arena allocator.
  *
  * Memory allocated by an arena allocator must not be used after its free.
+ * Pending deferred callbacks are run first, see `arena_defer`.
  *
  * @param arena Pointer to the arena allocator being freed.
  */
@@ -92,8 +360,238 @@ void arena_free(c_arena_t *arena);
  * @param arena Pointer to the arena being reset.
  * @return Whether the reset was succesful or not.
  *
+ * What happens to the reclaimed memory is decided by the arena's reset policy,
+ * see `arena_set_reset_policy`. Pending deferred callbacks are run first,
+ * see `arena_defer`.
+ *
  * @note Do not use previously assigned memory after a reset.
  */
 void arena_reset(c_arena_t *arena);
 
+/**
+ *
+ * @brief Registers a cleanup callback with an arena.
+ *
+ * Callbacks run in reverse order of registration when the arena is reset or
+ * freed, while the arena's memory is still intact. This ties resources the
+ * arena doesn't own, like vectors or file descriptors, to its lifetime.
+ * Rewinding to a mark runs the callbacks registered since the mark.
+ * The record is stored in the arena itself, no extra allocation is made.
+ *
+ * @param arena Pointer to the arena.
+ * @param fn Callback to run.
+ * @param ctx Passed to the callback.
+ * @return 0 on success, -1 if the record could not be allocated.
+ *
+ * @note The callback runs once, it is unregistered before being called.
+ */
+int arena_defer(c_arena_t *arena, c_arena_defer_t fn, void *ctx);
+
+/**
+ *
+ * @brief Resets an arena allocator, trimming the memory it keeps.
+ *
+ * Resets like `arena_reset`, then frees memory nodes beyond `retain` bytes
+ * so a single spike doesn't pin memory for the arena's lifetime.
+ * When the arena had grown into several nodes, the retained capacity is
+ * coalesced into a single node so later requests don't hop between nodes.
+ * The arena never shrinks below its initial size.
+ * Virtual arenas decommit pages past `retain` instead.
+ *
+ * @param arena Pointer to the arena being reset.
+ * @param retain Number of bytes to keep, or `ARENA_RETAIN_DECAYED` to keep
+ *        a high-water mark of recent resets that decays over time.
+ *
+ * @note Do not use previously assigned memory after a reset.
+ */
+void arena_reset_retain(c_arena_t *arena, size_t retain);
+
+/**
+ *
+ * @brief Sets the policy used by future calls to `arena_reset`.
+ *
+ * `ARENA_RESET_KEEP` is the cheapest, the memory is simply reused.
+ * `ARENA_RESET_ZERO_USED` only touches the prefix of each memory node that was used.
+ * `ARENA_RESET_RELEASE` hands pages back with `madvise`, so they no longer
+ * count towards resident memory until written again.
+ *
+ * @param arena Pointer to the arena.
+ * @param policy The reset policy to use.
+ *
+ * @note Released heap memory may read back as either zeroes or its old contents.
+ */
+void arena_set_reset_policy(c_arena_t *arena, c_arena_reset_policy_t policy);
+
+/**
+ *
+ * @brief Sets how a growable arena grows.
+ *
+ * When a request doesn't fit the current memory node, the arena moves to a
+ * new node sized by the growth schedule. Requests larger than the large
+ * threshold instead get a dedicated, exactly sized node kept outside of the
+ * bump allocator's chain, so the current node keeps being filled and no
+ * nodes are wasted chaining up to the request's size.
+ * Dedicated nodes released by `arena_reset` and `arena_rewind` are kept to
+ * serve later oversized requests, until `arena_reset_retain` or adaptive
+ * sizing trims the arena.
+ *
+ * @param arena Pointer to the arena.
+ * @param growth The growth schedule, `ARENA_DEFAULT_GROWTH` doubles each node.
+ * @return 0 on success, -1 on error.
+ */
+int arena_set_growth(c_arena_t *arena, c_arena_growth_t growth);
+
+/**
+ *
+ * @brief Sets the hook that receives an arena's events.
+ *
+ * The hook is called on creation, allocation, growth, reset, rewind and free,
+ * for feeding arenas into tracing or sampling.
+ * While a hook is installed every allocation takes the out-of-line slow path.
+ * Without one, the inline fast path is untouched.
+ *
+ * @param arena Pointer to the arena.
+ * @param hook The hook to call, or NULL to remove it.
+ * @param ctx Passed to every call of the hook.
+ *
+ * @note `ARENA_PRINT_DEBUG` installs a hook printing every event to stdout.
+ */
+void arena_set_hook(c_arena_t *arena, c_arena_hook_t hook, void *ctx);
+
+/**
+ *
+ * @brief Sets the hook installed in every arena created from now on.
+ *
+ * Unlike `arena_set_hook`, this also sees `ARENA_EVENT_CREATE`.
+ * Arenas created with `ARENA_PRINT_DEBUG` keep their printing hook.
+ *
+ * @param hook The hook to install, or NULL for none.
+ * @param ctx Passed to every call of the hook.
+ *
+ * @note Not thread safe, set it before creating arenas.
+ */
+void arena_set_default_hook(c_arena_hook_t hook, void *ctx);
+
+/**
+ *
+ * @brief Retrieves an arena's statistics.
+ *
+ * Counters are kept up to date as the arena is used at almost no cost,
+ * so this is safe to call in production, for example to size initial arenas.
+ *
+ * @param arena Pointer to the arena.
+ * @return A snapshot of the arena's statistics.
+ */
+c_arena_stats_t arena_stats(const c_arena_t *arena);
+
+/**
+ *
+ * @brief Captures the current position of an arena.
+ *
+ * The returned mark can later be passed to `arena_rewind` to reclaim
+ * everything allocated after it, while keeping what came before.
+ *
+ * @param arena Pointer to the arena.
+ * @return A mark of the arena's current position.
+ */
+c_arena_mark_t arena_mark(const c_arena_t *arena);
+
+/**
+ *
+ * @brief Rewinds an arena back to a previously captured mark.
+ *
+ * Memory allocated since the mark is reclaimed, including memory in any
+ * nodes the arena grew into. Those nodes are kept for reuse.
+ * Callbacks deferred since the mark are run first.
+ * Marks can be nested, rewinding to an outer mark invalidates inner ones.
+ *
+ * @param arena Pointer to the arena.
+ * @param mark A mark taken from the same arena since its last reset.
+ *
+ * @note Do not use memory allocated after the mark once rewound.
+ */
+void arena_rewind(c_arena_t *arena, c_arena_mark_t mark);
+
+/**
+ *
+ * @brief Points a self-relative pointer at a target.
+ *
+ * @param rel The relative pointer, stored in the same region as `target`.
+ * @param target What it points at, or NULL.
+ *
+ * @note A relative pointer can't point at itself, that reads back as NULL.
+ */
+inline void relptr_set(c_relptr_t *rel, const void *target) {
+  *rel = target == NULL ? 0 : (int64_t)((intptr_t)target - (intptr_t)rel);
+}
+
+/**
+ *
+ * @brief Resolves a self-relative pointer.
+ *
+ * @param rel The relative pointer.
+ * @return What it points at, or NULL.
+ */
+inline void *relptr_get(const c_relptr_t *rel) {
+  return *rel == 0 ? NULL : (char *)rel + *rel;
+}
+
+/**
+ *
+ * @brief Writes the used memory of a relocatable arena to a file.
+ *
+ * The arena must be created with `ARENA_RELOCATABLE`, and the structures in
+ * it must link to each other with `c_relptr_t` rather than plain pointers.
+ * The file can then be mapped back with `arena_load` without any parsing.
+ *
+ * @param arena Pointer to the arena.
+ * @param root The entry point to the structures, allocated from the arena.
+ * @param path Path of the file to write.
+ * @return 0 on success, -1 if the arena isn't relocatable, `root` isn't in
+ *         it, or the file couldn't be written.
+ *
+ * @note Callbacks registered with `arena_defer` are not carried over.
+ */
+int arena_save(const c_arena_t *arena, const void *root, const char *path);
+
+/**
+ *
+ * @brief Maps an image written by `arena_save` back into memory.
+ *
+ * The file is mapped read-only, so its pages come straight from the page
+ * cache and are shared between processes loading the same image.
+ *
+ * @param path Path of the file to load.
+ * @return Pointer to the image, or NULL if it can't be read or isn't an image.
+ */
+c_arena_image_t *arena_load(const char *path);
+
+/**
+ *
+ * @brief Retrieves the root that was passed to `arena_save`.
+ *
+ * @param image Pointer to the image.
+ * @return The root, within the mapped image.
+ */
+const void *arena_image_root(const c_arena_image_t *image);
+
+/**
+ *
+ * @brief Retrieves the size of an image's memory in bytes.
+ *
+ * @param image Pointer to the image.
+ * @return Number of bytes the arena had used when it was saved.
+ */
+size_t arena_image_size(const c_arena_image_t *image);
+
+/**
+ *
+ * @brief Unmaps an image.
+ *
+ * Memory within the image must not be used after its free.
+ *
+ * @param image Pointer to the image.
+ */
+void arena_image_free(c_arena_image_t *image);
+
 #endif
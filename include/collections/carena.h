@@ -0,0 +1,107 @@
+#ifndef CARENAH
+#define CARENAH
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdalign.h>
+
+/**
+ * @brief Concurrent arena
+ *
+ * An arena shared between threads. Each thread allocates through its own
+ * lease, a chunk taken from the shared arena with a single atomic operation,
+ * and bump-allocates inside it without any synchronisation.
+ * Everything is released at once with `carena_free` or `carena_reset`.
+ */
+typedef struct carena_t c_carena_t;
+
+/**
+ * @brief A thread's lease on a concurrent arena.
+ *
+ * Owned by a single thread, fields are internal to the arena.
+ */
+typedef struct {
+  c_carena_t *arena;
+  char *pos;
+  char *end;
+} c_carena_lease_t;
+
+/**
+ *
+ * @brief Creates a new concurrent arena.
+ *
+ * Reserves `reserve` bytes of address space up front, which leases are carved from.
+ * Pages are only backed by memory once written to.
+ *
+ * @param reserve Number of bytes of address space to reserve.
+ * @param chunk_size Number of bytes each lease takes from the arena.
+ * @return Pointer to concurrent arena, or NULL on failure.
+ *
+ * @note Must free via `carena_free`.
+ */
+c_carena_t *carena_create(size_t reserve, size_t chunk_size);
+
+/**
+ *
+ * @brief Frees a concurrent arena.
+ *
+ * All memory allocated from any lease on the arena is released.
+ *
+ * @param arena The concurrent arena to free.
+ *
+ * @note No thread may be using the arena during its free.
+ */
+void carena_free(c_carena_t *arena);
+
+/**
+ *
+ * @brief Resets a concurrent arena.
+ *
+ * All memory allocated from any lease on the arena is reclaimed.
+ *
+ * @param arena The concurrent arena to reset.
+ *
+ * @note No thread may be using the arena during its reset, and all
+ *       existing leases must be re-initialised via `carena_lease_init`.
+ */
+void carena_reset(c_carena_t *arena);
+
+/**
+ *
+ * @brief Creates an empty lease on a concurrent arena.
+ *
+ * The lease takes its first chunk on its first allocation.
+ *
+ * @param arena The concurrent arena to lease from.
+ * @return An empty lease.
+ */
+c_carena_lease_t carena_lease_init(c_carena_t *arena);
+
+/**
+ *
+ * @brief Allocates an aligned block of memory through a lease.
+ *
+ * Lock-free, only touching the shared arena when the lease runs out.
+ * Requests too large for a chunk are leased on their own, leaving the
+ * current chunk in place.
+ *
+ * @param lease The calling thread's lease.
+ * @param size Number of bytes to allocate.
+ * @param align The alignment of the memory, a power of 2.
+ * @return Pointer to the requested block of memory, or NULL on error.
+ *
+ * @note A lease must only be used by one thread at a time.
+ */
+void *carena_alloc(c_carena_lease_t *lease, size_t size, size_t align);
+
+/**
+ *
+ * @brief Retrieves the number of bytes leased from a concurrent arena.
+ *
+ * @param arena The concurrent arena.
+ * @return The number of bytes handed out to leases.
+ */
+size_t carena_used(const c_carena_t *arena);
+
+#endif
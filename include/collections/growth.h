@@ -0,0 +1,57 @@
+#ifndef GROWTHH
+#define GROWTHH
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Custom growth callback, see `c_growth_policy_t`.
+ *
+ * @param capacity The current capacity, in elements.
+ * @param required The capacity needed right now, in elements.
+ * @param ctx The policy's `ctx`.
+ * @return The capacity to grow to.
+ */
+typedef size_t (*c_growth_fn_t)(size_t capacity, size_t required, void *ctx);
+
+/**
+ * @brief How a container grows its capacity when full.
+ *
+ * The default policy keeps the container's built-in schedule, a mild
+ * CPython style over-allocation of about 1.125x. Append heavy containers
+ * that grow large reallocate and copy far less with a factor of 1.5 or 2.
+ */
+typedef struct {
+  double factor;       /**< Multiplies the capacity, at least 1. 0 keeps the built-in schedule. */
+  size_t min_step;     /**< Grows by at least this many elements. */
+  c_growth_fn_t custom; /**< Replaces `factor` when set. */
+  void *ctx;           /**< Passed to `custom`. */
+} c_growth_policy_t;
+
+#define GROWTH_POLICY_DEFAULT ((c_growth_policy_t){ .factor = 0, .min_step = 0, .custom = NULL, .ctx = NULL })
+
+/**
+ *
+ * @brief Checks whether a growth policy is valid.
+ *
+ * @param policy The policy to check.
+ * @return Whether the policy's factor is 0 or at least 1.
+ */
+bool growth_policy_valid(const c_growth_policy_t *policy);
+
+/**
+ *
+ * @brief Calculates the capacity a container grows to under a policy.
+ *
+ * The result always fits `required`, and always grows by at least one
+ * element and `min_step`, whatever the factor or callback returns.
+ *
+ * @param policy The container's policy.
+ * @param capacity The current capacity, in elements.
+ * @param required The capacity needed right now, in elements.
+ * @param builtin The capacity the container's built-in schedule would pick.
+ * @return The capacity to grow to.
+ */
+size_t growth_policy_next(const c_growth_policy_t *policy, size_t capacity, size_t required, size_t builtin);
+
+#endif
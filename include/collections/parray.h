@@ -5,6 +5,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
+#include "allocator.h"
+#include "growth.h"
 
 /**
  * @brief Pointer array
@@ -28,6 +31,21 @@ typedef struct parray_t c_parray_t;
  */
 c_parray_t *parray_create(void (*parray_free_func)(void*));
 
+/**
+ *
+ * @brief Creates a new pointer array using a custom allocator.
+ *
+ * The pointer array and its internals are allocated through `allocator`.
+ * The pointed to elements are still the caller's, freed by `parray_free_func`.
+ *
+ * @param parray_free_func Optional destructor function for child elements to be used during free.
+ * @param allocator The allocator to use, copied into the array. NULL uses `allocator_default`.
+ * @return Pointer to pointer array, or NULL on failure.
+ *
+ * @note Must free via `parray_free`.
+ */
+c_parray_t *parray_create_with_allocator(void (*parray_free_func)(void*), const c_allocator_t *allocator);
+
 
 /**
  *
@@ -108,4 +126,25 @@ int parray_insert(c_parray_t *parray, size_t index, void *ptr);
  */
 void *parray_pop(c_parray_t *parray, size_t index);
 
+/**
+ *
+ * @brief Gives a pointer array's unused capacity back to its allocator.
+ *
+ * Shrinks the capacity down to the array's length, at least one item.
+ *
+ * @param parray The pointer array to shrink.
+ * @return 0 on success, -1 on error.
+ */
+int parray_shrink_to_fit(c_parray_t *parray);
+
+/**
+ *
+ * @brief Sets how a pointer array grows when full.
+ *
+ * @param parray The pointer array.
+ * @param policy The growth policy, see `c_growth_policy_t`.
+ * @return 0 on success, -1 if the policy is invalid.
+ */
+int parray_set_growth(c_parray_t *parray, c_growth_policy_t policy);
+
 #endif
@@ -0,0 +1,67 @@
+#ifndef POOLH
+#define POOLH
+
+#include <stddef.h>
+#include "arena.h"
+
+#define POOL_SLAB_SIZE 4096
+
+/**
+ * @brief Fixed-size object pool
+ *
+ * Hands out objects of a single size from slabs carved out of an arena.
+ * Released objects are kept on an intrusive free list and handed out again
+ * before the pool carves new ones.
+ */
+typedef struct pool_t c_pool_t;
+
+/**
+ *
+ * @brief Creates a new object pool in an arena.
+ *
+ * The pool and all of its objects live in `arena`, so are all released
+ * at once by resetting or freeing the arena.
+ *
+ * @param arena The arena to allocate the pool and its slabs from.
+ * @param obj_size The size of the objects handed out by the pool.
+ * @return Pointer to pool, or NULL on failure.
+ *
+ * @note Do not use the pool after its arena is reset or freed, or rewound to
+ *       any mark taken after its creation. Slabs carved after the mark would
+ *       be handed out again while the arena reuses their memory.
+ */
+c_pool_t *pool_create(c_arena_t *arena, size_t obj_size);
+
+/**
+ *
+ * @brief Allocates an object from a pool.
+ *
+ * Objects are aligned to the smaller of `alignof(max_align_t)` and their
+ * size rounded up to a power of 2.
+ *
+ * @param pool The pool to allocate from.
+ * @return Pointer to an uninitialised object, or NULL on error.
+ */
+void *pool_alloc(c_pool_t *pool);
+
+/**
+ *
+ * @brief Releases an object back to its pool.
+ *
+ * The object will be handed out again by a later `pool_alloc`.
+ *
+ * @param pool The pool the object was allocated from.
+ * @param obj The object to release, may be NULL.
+ */
+void pool_release(c_pool_t *pool, void *obj);
+
+/**
+ *
+ * @brief Retrieves the size of the objects in a pool.
+ *
+ * @param pool The pool.
+ * @return The size each object was requested at.
+ */
+size_t pool_obj_size(const c_pool_t *pool);
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef SALLOCH
+#define SALLOCH
+
+#include <stddef.h>
+#include "arena.h"
+
+#define SALLOC_MIN_CLASS 16
+#define SALLOC_MAX_CLASS 4096
+
+/**
+ * @brief Size-class allocator
+ *
+ * A general purpose allocator layered on an arena. Requests are rounded up
+ * to a power of 2 size class between `SALLOC_MIN_CLASS` and `SALLOC_MAX_CLASS`,
+ * each served by its own pool, so freed blocks are reused by later requests
+ * of the same class. Everything is released at once with the arena.
+ */
+typedef struct salloc_t c_salloc_t;
+
+/**
+ *
+ * @brief Creates a new size-class allocator in an arena.
+ *
+ * The allocator and all of its blocks live in `arena`.
+ *
+ * @param arena The arena to allocate from, should be `ARENA_GROWABLE`.
+ * @return Pointer to the allocator, or NULL on failure.
+ *
+ * @note Do not use the allocator after its arena is reset or freed, or rewound to
+ *       any mark taken after its creation, as its size classes would keep
+ *       handing out blocks from memory the arena has reclaimed.
+ */
+c_salloc_t *salloc_create(c_arena_t *arena);
+
+/**
+ *
+ * @brief Allocates a block of memory.
+ *
+ * Blocks are aligned to `alignof(max_align_t)`.
+ *
+ * @param salloc The allocator.
+ * @param size Number of bytes to allocate.
+ * @return Pointer to the block, or NULL on error.
+ *
+ * @note Blocks above `SALLOC_MAX_CLASS` come straight from the arena and
+ *       aren't reused once freed, until the arena is.
+ */
+void *salloc_alloc(c_salloc_t *salloc, size_t size);
+
+/**
+ *
+ * @brief Frees a block of memory.
+ *
+ * The block is handed out again by a later request of the same size class.
+ *
+ * @param salloc The allocator the block came from.
+ * @param ptr The block to free, may be NULL.
+ */
+void salloc_free(c_salloc_t *salloc, void *ptr);
+
+/**
+ *
+ * @brief Resizes a block of memory.
+ *
+ * Returns the same block when the new size still fits its size class,
+ * otherwise moves the contents to a new block.
+ *
+ * @param salloc The allocator the block came from.
+ * @param ptr The block to resize, or NULL to allocate a new one.
+ * @param size The new size in bytes, or 0 to free the block.
+ * @return Pointer to the resized block, or NULL on error or when freed.
+ *
+ * @note On error the original block is left untouched.
+ */
+void *salloc_realloc(c_salloc_t *salloc, void *ptr, size_t size);
+
+/**
+ *
+ * @brief Retrieves the usable size of a block.
+ *
+ * @param ptr A block from a size-class allocator.
+ * @return The number of bytes usable in the block, at least the requested size.
+ */
+size_t salloc_usable_size(const void *ptr);
+
+/**
+ *
+ * @brief Creates an allocator interface backed by a size-class allocator.
+ *
+ * Lets collections grow by reusing freed blocks, while living in the arena.
+ *
+ * @param salloc The size-class allocator.
+ * @return An allocator allocating from `salloc`.
+ */
+c_allocator_t salloc_allocator(c_salloc_t *salloc);
+
+#endif
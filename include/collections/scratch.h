@@ -0,0 +1,58 @@
+#ifndef SCRATCHH
+#define SCRATCHH
+
+#include <stddef.h>
+#include "arena.h"
+
+#define SCRATCH_POOL_COUNT 2
+#define SCRATCH_ARENA_SIZE (64 * 1024)
+
+/**
+ * @brief A temporary region of a thread's scratch arena.
+ *
+ * Allocate from `arena` between `scratch_begin` and `scratch_end`.
+ */
+typedef struct {
+  c_arena_t *arena;
+  c_arena_mark_t mark;
+} c_scratch_t;
+
+/**
+ *
+ * @brief Begins a temporary scratch region.
+ *
+ * Hands out one of the calling thread's scratch arenas, skipping any arena
+ * listed in `conflicts`. Passing the arena a caller wants results written to
+ * guarantees scratch memory never aliases it.
+ * The thread's arenas are created on first use and then reused, so in steady
+ * state this neither allocates nor makes syscalls.
+ *
+ * @param conflicts Arenas that must not be returned, may be NULL if `conflict_count` is 0.
+ * @param conflict_count Number of arenas in `conflicts`.
+ * @return A scratch region, whose `arena` is NULL on failure.
+ *
+ * @note Must be ended via `scratch_end`, in reverse order of beginning.
+ */
+c_scratch_t scratch_begin(c_arena_t *const *conflicts, size_t conflict_count);
+
+/**
+ *
+ * @brief Ends a temporary scratch region.
+ *
+ * Everything allocated from the scratch arena since `scratch_begin` is reclaimed.
+ *
+ * @param scratch The scratch region to end.
+ */
+void scratch_end(c_scratch_t scratch);
+
+/**
+ *
+ * @brief Frees the calling thread's scratch arenas.
+ *
+ * A thread's scratch arenas are freed automatically when it exits, so this
+ * is only needed to release them early, or from the main thread.
+ * They are recreated if `scratch_begin` is called again.
+ */
+void scratch_thread_free(void);
+
+#endif
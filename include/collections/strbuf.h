@@ -0,0 +1,112 @@
+#ifndef STRBUFH
+#define STRBUFH
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "arena.h"
+
+#define STRBUF_INITIAL_CAP 64
+
+/**
+ * @brief An immutable string slice.
+ *
+ * `ptr` is followed by a NUL terminator, which `len` doesn't count.
+ */
+typedef struct {
+  const char *ptr;
+  size_t len;
+} c_str_t;
+
+/**
+ * @brief Arena-backed string builder
+ *
+ * Appends into a buffer at the tail of an arena. While the buffer is the
+ * arena's most recent allocation it grows in place, otherwise it moves.
+ * Fields are internal to the builder.
+ */
+typedef struct {
+  c_arena_t *arena;
+  char *data;
+  size_t len;
+  size_t cap;
+} c_strbuf_t;
+
+/**
+ *
+ * @brief Initialises a string builder.
+ *
+ * Nothing is allocated until the first append.
+ *
+ * @param buf The builder to initialise.
+ * @param arena The arena to build the string in.
+ */
+void strbuf_init(c_strbuf_t *buf, c_arena_t *arena);
+
+/**
+ *
+ * @brief Appends bytes to a string builder.
+ *
+ * @param buf The builder.
+ * @param str The bytes to append.
+ * @param len Number of bytes to append.
+ * @return Whether the append was successful or not.
+ */
+bool strbuf_append(c_strbuf_t *buf, const char *str, size_t len);
+
+/**
+ *
+ * @brief Appends a NUL terminated string to a string builder.
+ *
+ * @param buf The builder.
+ * @param str The string to append.
+ * @return Whether the append was successful or not.
+ */
+bool strbuf_append_cstr(c_strbuf_t *buf, const char *str);
+
+/**
+ *
+ * @brief Appends a single character to a string builder.
+ *
+ * @param buf The builder.
+ * @param c The character to append.
+ * @return Whether the append was successful or not.
+ */
+bool strbuf_append_char(c_strbuf_t *buf, char c);
+
+/**
+ *
+ * @brief Appends formatted output to a string builder.
+ *
+ * Formats straight into the buffer, like `snprintf`.
+ *
+ * @param buf The builder.
+ * @param fmt The `printf` style format string.
+ * @return Whether the append was successful or not.
+ */
+bool strbuf_appendf(c_strbuf_t *buf, const char *fmt, ...);
+
+/**
+ *
+ * @brief Retrieves the number of bytes appended to a string builder.
+ *
+ * @param buf The builder.
+ * @return Number of bytes appended so far.
+ */
+size_t strbuf_len(const c_strbuf_t *buf);
+
+/**
+ *
+ * @brief Finishes a string builder into an immutable slice.
+ *
+ * The string is NUL terminated, and the arena space reserved past it is
+ * handed back when the buffer is still the arena's last allocation.
+ * The builder is left empty, ready to build the next string.
+ *
+ * @param buf The builder.
+ * @return The finished string, or a slice with a NULL `ptr` on error.
+ *
+ * @note The string lives in the arena, do not free() it manually.
+ */
+c_str_t strbuf_finish(c_strbuf_t *buf);
+
+#endif
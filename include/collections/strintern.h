@@ -0,0 +1,86 @@
+#ifndef STRINTERNH
+#define STRINTERNH
+
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+#include "strbuf.h"
+
+#define STRINTERN_INVALID UINT32_MAX
+
+/**
+ * @brief Arena-backed string interner
+ *
+ * Deduplicates strings into an arena, handing each distinct string a stable
+ * id. Interned strings are stored once, NUL terminated, and never move, so
+ * equal strings can be compared by id or by pointer.
+ * The hash table is kept on the heap so growing it doesn't waste arena space.
+ */
+typedef struct strintern_t c_strintern_t;
+
+/**
+ *
+ * @brief Creates a new string interner.
+ *
+ * @param arena The arena interned strings are copied into.
+ * @return Pointer to interner, or NULL on failure.
+ *
+ * @note Must free via `strintern_free`. The arena must outlive the interner.
+ */
+c_strintern_t *strintern_create(c_arena_t *arena);
+
+/**
+ *
+ * @brief Frees a string interner.
+ *
+ * Interned strings stay valid until their arena is reset or freed.
+ *
+ * @param interner The interner to free.
+ */
+void strintern_free(c_strintern_t *interner);
+
+/**
+ *
+ * @brief Interns a string.
+ *
+ * Returns the id of an equal string interned earlier, or copies the string
+ * into the arena under the next id. Ids count up from 0.
+ *
+ * @param interner The interner.
+ * @param str The string, which doesn't need to be NUL terminated.
+ * @param len Length of the string in bytes.
+ * @return The string's id, or `STRINTERN_INVALID` on error.
+ */
+uint32_t strintern_intern(c_strintern_t *interner, const char *str, size_t len);
+
+/**
+ *
+ * @brief Looks up a string without interning it.
+ *
+ * @param interner The interner.
+ * @param str The string, which doesn't need to be NUL terminated.
+ * @param len Length of the string in bytes.
+ * @return The string's id, or `STRINTERN_INVALID` if it was never interned.
+ */
+uint32_t strintern_lookup(const c_strintern_t *interner, const char *str, size_t len);
+
+/**
+ *
+ * @brief Retrieves an interned string by its id.
+ *
+ * @param interner The interner.
+ * @param id An id returned by `strintern_intern`.
+ * @return The interned string, or a slice with a NULL `ptr` for an unknown id.
+ */
+c_str_t strintern_get(const c_strintern_t *interner, uint32_t id);
+
+/**
+ *
+ * @brief Retrieves the number of distinct strings interned.
+ *
+ * @param interner The interner.
+ * @return Number of strings, which is also the next id.
+ */
+size_t strintern_count(const c_strintern_t *interner);
+
+#endif
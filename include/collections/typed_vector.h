@@ -0,0 +1,100 @@
+#ifndef TYPED_VECTORH
+#define TYPED_VECTORH
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "allocator.h"
+#include "vector.h"
+
+/**
+ * @brief Declares a vector specialised for element type `T`.
+ *
+ * Expands to the type `c_vector_<name>_t` and static inline functions
+ * `vector_<name>_<op>` working on a typed data pointer, so element access
+ * compiles down to plain loads and stores rather than `memcpy` calls with a
+ * runtime element size. Capacity grows exactly like `c_vector_t`, through
+ * `vector_grow_capacity`.
+ *
+ * Typed vectors are plain values: initialise one with `vector_<name>_init`,
+ * release it with `vector_<name>_free`. `data` may be read directly.
+ *
+ * @code
+ * VECTOR_DECLARE(int32_t, i32)
+ *
+ * c_vector_i32_t v;
+ * vector_i32_init(&v, NULL);
+ * vector_i32_push(&v, 42);
+ * int32_t first;
+ * vector_i32_get(&v, 0, &first);
+ * vector_i32_free(&v);
+ * @endcode
+ *
+ * @param T The element type.
+ * @param name Suffix naming the type and its functions.
+ */
+#define VECTOR_DECLARE(T, name) \
+  typedef struct { \
+    T *data; \
+    size_t size; \
+    size_t capacity; \
+    c_allocator_t allocator; \
+  } c_vector_##name##_t; \
+  \
+  /* Nothing is allocated until the first element is added. NULL uses `allocator_default`. */ \
+  static inline void vector_##name##_init(c_vector_##name##_t *vector, const c_allocator_t *allocator) { \
+    vector->data = NULL; \
+    vector->size = 0; \
+    vector->capacity = 0; \
+    vector->allocator = allocator != NULL ? *allocator : allocator_default(); \
+  } \
+  \
+  static inline void vector_##name##_free(c_vector_##name##_t *vector) { \
+    vector->allocator.free(vector->allocator.ctx, vector->data, vector->capacity * sizeof(T)); \
+    vector->data = NULL; \
+    vector->size = 0; \
+    vector->capacity = 0; \
+  } \
+  \
+  static inline int vector_##name##_reserve(c_vector_##name##_t *vector, size_t capacity) { \
+    if (capacity <= vector->capacity) return 0; \
+    if (capacity > SIZE_MAX / sizeof(T)) return -1; \
+    T *data = (T *)vector->allocator.realloc(vector->allocator.ctx, vector->data, \
+                                             vector->capacity * sizeof(T), capacity * sizeof(T)); \
+    if (data == NULL) return -1; \
+    vector->data = data; \
+    vector->capacity = capacity; \
+    return 0; \
+  } \
+  \
+  static inline int vector_##name##_push(c_vector_##name##_t *vector, T value) { \
+    if (vector->size == vector->capacity \
+        && vector_##name##_reserve(vector, vector_grow_capacity(vector->capacity)) == -1) return -1; \
+    vector->data[vector->size++] = value; \
+    return 0; \
+  } \
+  \
+  static inline int vector_##name##_pop(c_vector_##name##_t *vector, T *out) { \
+    if (vector->size == 0) return -1; \
+    vector->size--; \
+    if (out != NULL) *out = vector->data[vector->size]; \
+    return 0; \
+  } \
+  \
+  static inline int vector_##name##_get(const c_vector_##name##_t *vector, size_t index, T *out) { \
+    if (out == NULL || index >= vector->size) return -1; \
+    *out = vector->data[index]; \
+    return 0; \
+  } \
+  \
+  static inline int vector_##name##_set(c_vector_##name##_t *vector, size_t index, T value) { \
+    if (index >= vector->size) return -1; \
+    vector->data[index] = value; \
+    return 0; \
+  } \
+  \
+  static inline size_t vector_##name##_size(const c_vector_##name##_t *vector) { \
+    return vector->size; \
+  }
+
+#endif
@@ -4,9 +4,12 @@
 typedef struct vector_t c_vector_t;
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include "allocator.h"
+#include "growth.h"
 
 /**
  *
@@ -21,6 +24,22 @@ typedef struct vector_t c_vector_t;
  */
 c_vector_t *vector_create(size_t elem_size);
 
+/**
+ *
+ * @brief Creates a vector using a custom allocator.
+ *
+ * Creates a vector, a dynamic homogenous array.
+ * The vector and its elements are allocated through `allocator`, so a vector
+ * made with an `arena_allocator` is released along with its arena.
+ *
+ * @param elem_size The size of the elements to be contained by the vector.
+ * @param allocator The allocator to use, copied into the vector. NULL uses `allocator_default`.
+ * @return The newly created vector, or NULL on error.
+ *
+ * @note Do not free the vector manually, use `vector_free()`.
+ */
+c_vector_t *vector_create_with_allocator(size_t elem_size, const c_allocator_t *allocator);
+
 /**
  *
  * @brief Frees a vector.
@@ -59,6 +78,45 @@ int vector_set(c_vector_t *vector, size_t index, const void *value);
  */
 int vector_get(const c_vector_t *vector, size_t index, void *out);
 
+/**
+ *
+ * @brief Retrieves a pointer to an element in a vector.
+ *
+ * Gives direct access to an element without copying it out.
+ *
+ * @param vector The vector to retrieve from.
+ * @param index The index of the element.
+ * @return Pointer to the element, or NULL on error.
+ *
+ * @note The pointer is invalidated by any operation that changes the vector's capacity.
+ */
+void *vector_at(const c_vector_t *vector, size_t index);
+
+/**
+ *
+ * @brief Retrieves a pointer to the last element in a vector.
+ *
+ * @param vector The vector to retrieve from.
+ * @return Pointer to the last element, or NULL if the vector is empty or on error.
+ *
+ * @note The pointer is invalidated by any operation that changes the vector's capacity.
+ */
+void *vector_back(const c_vector_t *vector);
+
+/**
+ *
+ * @brief Retrieves a vector's underlying contiguous storage.
+ *
+ * Elements are stored back to back, `vector_size` of them, so the span can
+ * be handed straight to bulk consumers such as `write()` or SIMD kernels.
+ *
+ * @param vector The vector to retrieve the storage of.
+ * @return Pointer to the first element, or NULL on error.
+ *
+ * @note The pointer is invalidated by any operation that changes the vector's capacity.
+ */
+void *vector_data(const c_vector_t *vector);
+
 /**
  *
  * @brief Inserts an element at an index within a vector.
@@ -75,6 +133,65 @@ int vector_get(const c_vector_t *vector, size_t index, void *out);
  */
 int vector_insert(c_vector_t *vector, size_t index, const void *value);
 
+/**
+ *
+ * @brief Inserts a range of elements at an index within a vector.
+ *
+ * Existing values are pushed forward once to make space for the whole range,
+ * with at most one reallocation.
+ *
+ * @param vector The vector to insert into.
+ * @param index The index to insert the first element at.
+ * @param values The contiguous elements to insert.
+ * @param count The number of elements to insert.
+ * @return 0 on success, -1 on error.
+ *
+ * @note Index needs to be below or equal to the size of the vector.
+ *       `values` may point into the vector itself.
+ */
+int vector_insert_range(c_vector_t *vector, size_t index, const void *values, size_t count);
+
+/**
+ *
+ * @brief Appends a range of elements to the back of a vector.
+ *
+ * Appends with at most one reallocation and a single copy.
+ *
+ * @param vector The vector to append to.
+ * @param values The contiguous elements to append.
+ * @param count The number of elements to append.
+ * @return 0 on success, -1 on error.
+ *
+ * @note `values` may point into the vector itself.
+ */
+int vector_append_n(c_vector_t *vector, const void *values, size_t count);
+
+/**
+ *
+ * @brief Removes a range of elements from a vector.
+ *
+ * Elements after the range are moved back once to fill the gap.
+ *
+ * @param vector The vector to remove elements from.
+ * @param index The index of the first element to remove.
+ * @param count The number of elements to remove.
+ * @return 0 on success, -1 on error.
+ */
+int vector_erase_range(c_vector_t *vector, size_t index, size_t count);
+
+/**
+ *
+ * @brief Replaces a vector's contents with a range of elements.
+ *
+ * @param vector The vector to assign to.
+ * @param values The contiguous elements to copy in.
+ * @param count The number of elements.
+ * @return 0 on success, -1 on error.
+ *
+ * @note `values` may point into the vector itself.
+ */
+int vector_assign(c_vector_t *vector, const void *values, size_t count);
+
 /**
  *
  * @brief Removes an item from a vector.
@@ -89,17 +206,61 @@ int vector_insert(c_vector_t *vector, size_t index, const void *value);
  */
 int vector_remove(c_vector_t *vector, size_t index, void *out);
 
+/*
+ * Storage of a vector, read by the inline push_back fast path.
+ * It is the first member of every vector. Do not touch it directly.
+ */
+struct vector_head {
+  void *mem;
+  size_t size;
+  size_t capacity;
+  size_t elem_size;
+};
+
+/**
+ *
+ * @brief Slow path of `vector_push_back`.
+ *
+ * Handles growing the vector and reporting errors.
+ *
+ * @note Internal, call `vector_push_back` instead.
+ */
+int vector_push_back_slow(c_vector_t *vector, const void *value);
+
 /**
  *
  * @brief Pushes a value to the back of a vector.
  *
  * Pushes a value to the back of a vector.
+ * When the vector has spare capacity, this is an inline copy into the next slot.
  *
  * @param vector The vector to push into.
  * @param value The value to push.
  * @return 0 on success, -1 on error.
  */
-int vector_push_back(c_vector_t *vector, const void *value);
+inline int vector_push_back(c_vector_t *vector, const void *value) {
+  struct vector_head *head = (struct vector_head *)vector;
+  if (vector != NULL && value != NULL && head->size < head->capacity) {
+    memcpy((char *)head->mem + head->size * head->elem_size, value, head->elem_size);
+    head->size++;
+    return 0;
+  }
+  return vector_push_back_slow(vector, value);
+}
+
+/**
+ *
+ * @brief Appends an uninitialised element to the back of a vector.
+ *
+ * Makes room for one more element and returns it to be constructed in place,
+ * avoiding the copy from a caller buffer that `vector_push_back` makes.
+ *
+ * @param vector The vector to append to.
+ * @return Pointer to the new, uninitialised element, or NULL on error.
+ *
+ * @note The pointer is invalidated by any operation that changes the vector's capacity.
+ */
+void *vector_emplace_back(c_vector_t *vector);
 
 /**
  *
@@ -166,6 +327,39 @@ size_t vector_size(const c_vector_t *vector);
  */
 size_t vector_capacity(const c_vector_t *vector);
 
+/**
+ *
+ * @brief Gives a vector's unused capacity back to its allocator.
+ *
+ * Shrinks the capacity down to the vector's size, at least one element.
+ *
+ * @param vector The vector to shrink.
+ * @return 0 on success, -1 on error.
+ */
+int vector_shrink_to_fit(c_vector_t *vector);
+
+/**
+ *
+ * @brief Sets how a vector grows when full.
+ *
+ * @param vector The vector.
+ * @param policy The growth policy, see `c_growth_policy_t`.
+ * @return 0 on success, -1 if the policy is invalid.
+ */
+int vector_set_growth(c_vector_t *vector, c_growth_policy_t policy);
+
+/**
+ *
+ * @brief Calculates the capacity a vector grows to when full.
+ *
+ * This is the built-in schedule, used unless a growth policy is set.
+ * Shared with the typed vectors from `typed_vector.h`, so both grow alike.
+ *
+ * @param capacity The current capacity.
+ * @return The capacity to grow to, always greater than `capacity`.
+ */
+size_t vector_grow_capacity(size_t capacity);
+
 /**
  *
  * @brief Returns whether a vector is empty or not.
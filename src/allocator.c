@@ -0,0 +1,29 @@
+#include "../include/collections/allocator.h"
+
+#include <stdlib.h>
+
+static void *libc_alloc(void *ctx, size_t size) {
+  (void)ctx;
+  return malloc(size);
+}
+
+static void *libc_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size) {
+  (void)ctx;
+  (void)old_size;
+  return realloc(ptr, new_size);
+}
+
+static void libc_free(void *ctx, void *ptr, size_t size) {
+  (void)ctx;
+  (void)size;
+  free(ptr);
+}
+
+c_allocator_t allocator_default(void) {
+  return (c_allocator_t){
+    .alloc = libc_alloc,
+    .realloc = libc_realloc,
+    .free = libc_free,
+    .ctx = NULL,
+  };
+}
@@ -1,183 +1,905 @@
+#define _GNU_SOURCE
 #include "../include/collections/arena.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #define FLAG_ENABLED(arena, flag) ((arena->flags & flag) == flag)
 
+// Each reset, the decayed high-water mark loses this power of 2 fraction of itself
+#define ARENA_DECAY_SHIFT 2
+
+// Virtual arenas commit in steps of this many bytes to limit mprotect calls
+#define ARENA_COMMIT_GRANULARITY ((size_t)64 * 1024)
+
+// Images start with a header padded to this size, keeping the arena's memory page aligned
+#define ARENA_IMAGE_HEADER_SIZE ((size_t)4096)
+#define ARENA_IMAGE_MAGIC "CARENA01"
+
+// Size of the pages backing `ARENA_HUGE_PAGES` and `ARENA_HUGETLB` arenas
+#define ARENA_HUGE_PAGE_SIZE ((size_t)2 * 1024 * 1024)
+
 typedef struct arena_t arena_t;
+typedef struct arena_image_t arena_image_t;
 typedef struct mem_node mem_node;
+typedef struct defer_record defer_record;
 
 struct mem_node {
   void *memory; // 8
   mem_node *next; // 8
   size_t size; // 8
   size_t used; // 8
+  size_t dirty; // 8 - Furthest `used` reached since the last reset, which rewinding doesn't lower
+  size_t committed; // 8 - Only meaningful for virtual arenas
+  bool mapped; // 1 - Memory came from mmap rather than malloc
+};
+
+// Stored in the arena's own memory, newest first
+struct defer_record {
+  c_arena_defer_t fn; // 8
+  void *ctx; // 8
+  defer_record *prev; // 8
 };
 
+struct arena_image_t {
+  void *map; // 8
+  size_t map_size; // 8
+  const char *memory; // 8
+  size_t size; // 8
+  size_t root; // 8
+};
+
+// Start of every image file
+typedef struct {
+  char magic[8]; // 8
+  uint64_t size; // 8
+  uint64_t root; // 8
+} image_header;
+
 struct arena_t {
-  void *pos; // 8
+  struct arena_bump bump; // 32 - Must be first, read by the inline fast path
   mem_node *head; // 8
   mem_node *cur; // 8
+  mem_node *large; // 8 - Dedicated nodes for oversized requests, newest first
+  mem_node *spare; // 8 - Dedicated nodes handed back by reset or rewind, kept for reuse
+  defer_record *defers; // 8
   size_t size; // 8
-  size_t used; // 8
+  size_t initial_size; // 8
+  size_t used; // 8 - Only counts nodes before `cur`, its usage is implied by `bump.pos`
+  c_arena_growth_t growth; // 32
+  size_t stranded; // 8
+  size_t high_water; // 8
+  size_t decayed_high_water; // 8
+  size_t grow_count; // 8
+  c_arena_hook_t hook; // 8
+  void *hook_ctx; // 8
   int flags; // 4
+  c_arena_reset_policy_t reset_policy; // 4
 };
 
-static mem_node *create_memory_node(size_t size) {
+static size_t page_size(void) {
+  static size_t cached = 0;
+  if (cached == 0) {
+    long ps = sysconf(_SC_PAGESIZE);
+    cached = ps > 0 ? (size_t)ps : 4096;
+  }
+  return cached;
+}
+
+static size_t round_up(size_t n, size_t multiple) {
+  return (n + multiple - 1) / multiple * multiple;
+}
+
+// Maps `size` bytes aligned to `align`, by over-mapping and trimming the excess
+static void *map_aligned(size_t size, size_t align, int prot, int map_flags) {
+  size_t padded = size + align;
+  char *raw = mmap(NULL, padded, prot, MAP_PRIVATE | MAP_ANONYMOUS | map_flags, -1, 0);
+  if (raw == MAP_FAILED) return NULL;
+
+  char *aligned = (char *)round_up((uintptr_t)raw, align);
+  char *end = aligned + size;
+  if (aligned > raw) munmap(raw, aligned - raw);
+  if (raw + padded > end) munmap(end, raw + padded - end);
+
+  return aligned;
+}
+
+// Maps memory backed by huge pages, rounding `*size` up to whole huge pages
+static void *map_huge_memory(size_t *size, int flags) {
+  size_t rounded = round_up(*size > 0 ? *size : 1, ARENA_HUGE_PAGE_SIZE);
+
+  if ((flags & ARENA_HUGETLB) == ARENA_HUGETLB) {
+    void *memory = mmap(NULL, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (memory != MAP_FAILED) {
+      *size = rounded;
+      return memory;
+    }
+    // No huge pages reserved with the kernel, fall back to transparent ones
+  }
+
+  void *memory = map_aligned(rounded, ARENA_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, 0);
+  if (memory == NULL) return NULL;
+  madvise(memory, rounded, MADV_HUGEPAGE);
+  *size = rounded;
+
+  return memory;
+}
+
+static bool wants_huge_pages(int flags) {
+  return (flags & (ARENA_HUGE_PAGES | ARENA_HUGETLB)) != 0;
+}
+
+static mem_node *create_memory_node(size_t size, int flags) {
   mem_node *new_block = (mem_node *)malloc(sizeof(mem_node));
   if (new_block == NULL) {
     return NULL;
   }
-  new_block->memory = malloc(size);
+  if (wants_huge_pages(flags)) {
+    new_block->memory = map_huge_memory(&size, flags);
+    new_block->mapped = true;
+  } else {
+    new_block->memory = malloc(size);
+    new_block->mapped = false;
+  }
   if (new_block->memory == NULL) {
     free(new_block);
     return NULL;
   }
   new_block->size = size;
   new_block->used = 0;
+  new_block->dirty = 0;
+  new_block->committed = size;
+  new_block->next = NULL;
+
+  return new_block;
+}
+
+// Reserves address space only, pages are committed by `commit_virtual_node`
+static mem_node *create_virtual_node(size_t size, int flags) {
+  mem_node *new_block = (mem_node *)malloc(sizeof(mem_node));
+  if (new_block == NULL) {
+    return NULL;
+  }
+  void *memory;
+  if (wants_huge_pages(flags)) {
+    // Reserved in whole huge pages, so transparent huge pages can back each commit.
+    // `MAP_HUGETLB` pages are committed when mapped, so aren't tried here
+    size = round_up(size > 0 ? size : 1, ARENA_HUGE_PAGE_SIZE);
+    memory = map_aligned(size, ARENA_HUGE_PAGE_SIZE, PROT_NONE, MAP_NORESERVE);
+    if (memory != NULL) madvise(memory, size, MADV_HUGEPAGE);
+  } else {
+    size = round_up(size, page_size());
+    memory = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (memory == MAP_FAILED) memory = NULL;
+  }
+  if (memory == NULL) {
+    free(new_block);
+    return NULL;
+  }
+  new_block->memory = memory;
+  new_block->mapped = true;
+  new_block->size = size;
+  new_block->used = 0;
+  new_block->dirty = 0;
+  new_block->committed = 0;
   new_block->next = NULL;
 
   return new_block;
 }
 
+// Ensures at least `required` bytes from the start of the node are usable
+static bool commit_virtual_node(mem_node *node, size_t required, size_t granularity) {
+  if (required <= node->committed) return true;
+  if (required > node->size) return false;
+
+  size_t target = round_up(required, granularity);
+  if (target > node->size) target = node->size;
+
+  char *start = (char *)node->memory + node->committed;
+  if (mprotect(start, target - node->committed, PROT_READ | PROT_WRITE) != 0) {
+    return false;
+  }
+  node->committed = target;
+  return true;
+}
+
+// Hands committed pages past `keep` bytes back to the OS, keeping the reservation
+static void decommit_virtual_node(mem_node *node, size_t keep) {
+  keep = round_up(keep, page_size());
+  if (node->committed <= keep) return;
+  char *start = (char *)node->memory + keep;
+  madvise(start, node->committed - keep, MADV_DONTNEED);
+  mprotect(start, node->committed - keep, PROT_NONE);
+  node->committed = keep;
+}
+
+// Heap nodes aren't page aligned, so only the whole pages inside the used prefix can go back
+static void release_heap_node(mem_node *node) {
+  uintptr_t start = round_up((uintptr_t)node->memory, page_size());
+  uintptr_t end = ((uintptr_t)node->memory + node->used) / page_size() * page_size();
+  if (end <= start) return;
+#ifdef MADV_FREE
+  if (madvise((void *)start, end - start, MADV_FREE) == 0) return;
+#endif
+  madvise((void *)start, end - start, MADV_DONTNEED);
+}
+
+static void free_memory_node(mem_node *node) {
+  if (node->mapped) {
+    munmap(node->memory, node->size);
+  } else {
+    free(node->memory);
+  }
+  free(node);
+}
+
+static void free_memory_nodes(mem_node *node) {
+  while (node != NULL) {
+    mem_node *next = node->next;
+    free_memory_node(node);
+    node = next;
+  }
+}
+
+// Moves dedicated nodes onto the spare list until reaching `until`, which is kept
+static void retire_large_nodes(arena_t *arena, mem_node *until) {
+  while (arena->large != until) {
+    mem_node *node = arena->large;
+    arena->large = node->next;
+    node->next = arena->spare;
+    arena->spare = node;
+  }
+}
+
+static void free_spare_nodes(arena_t *arena) {
+  while (arena->spare != NULL) {
+    mem_node *node = arena->spare;
+    arena->spare = node->next;
+    arena->size -= node->size;
+    free_memory_node(node);
+  }
+}
+
+static size_t commit_granularity(const arena_t *arena) {
+  return wants_huge_pages(arena->flags) ? ARENA_HUGE_PAGE_SIZE : ARENA_COMMIT_GRANULARITY;
+}
+
+// Emitted here so the inline functions have a single out-of-line definition in the library
+extern inline void *arena_alloc_aligned(arena_t *arena, size_t size, size_t align);
+extern inline void *arena_alloc(arena_t *arena, size_t size);
+extern inline void *arena_alloc_array(arena_t *arena, size_t count, size_t elem_size, size_t align);
+extern inline int arena_alloc_many(arena_t *arena, c_arena_block_t *blocks, size_t count);
+extern inline void relptr_set(c_relptr_t *rel, const void *target);
+extern inline void *relptr_get(const c_relptr_t *rel);
+
+static c_arena_hook_t default_hook = NULL;
+static void *default_hook_ctx = NULL;
+
+static const char *event_names[] = {
+  [ARENA_EVENT_CREATE] = "Created",
+  [ARENA_EVENT_ALLOC] = "Allocated",
+  [ARENA_EVENT_GROW] = "Grew",
+  [ARENA_EVENT_RESET] = "Reset",
+  [ARENA_EVENT_REWIND] = "Rewound",
+  [ARENA_EVENT_FREE] = "Freeing",
+};
+
+// Installed by `ARENA_PRINT_DEBUG`
+static void arena_print_hook(arena_t *arena, const c_arena_event_t *event, void *ctx) {
+  (void)ctx;
+  printf("ARENA %lx : %s! size %lu, align %lu, ptr %lx\n", (uintptr_t)arena, event_names[event->kind],
+         event->size, event->align, (uintptr_t)event->ptr);
+}
+
+static void arena_emit(arena_t *arena, c_arena_event_kind_t kind, size_t size, size_t align, void *ptr) {
+  if (arena->hook == NULL) return;
+  c_arena_event_t event = {
+    .kind = kind,
+    .size = size,
+    .align = align,
+    .ptr = ptr,
+  };
+  arena->hook(arena, &event, arena->hook_ctx);
+}
+
+// Points the bump allocator at the usable part of `node`, starting at `pos`
+static void arena_set_cur(arena_t *arena, mem_node *node, char *pos) {
+  arena->cur = node;
+  arena->bump.pos = pos;
+  // Hooks are called from the slow path, so keep the fast path from ever succeeding
+  if (arena->hook != NULL) {
+    arena->bump.end = NULL;
+  } else {
+    arena->bump.end = (char *)node->memory + node->committed;
+  }
+}
+
+// Brings `cur->used` up to date with the bump pointer
+static void arena_sync_cur(arena_t *arena) {
+  arena->cur->used = (uintptr_t)arena->bump.pos - (uintptr_t)arena->cur->memory;
+}
+
+// Lowers a node's usage, remembering how far it was written for the reset policy
+static void rewind_node(mem_node *node, size_t used) {
+  if (node->used > node->dirty) node->dirty = node->used;
+  node->used = used;
+}
+
+static size_t arena_used_bytes(const arena_t *arena) {
+  size_t used = arena->used + ((uintptr_t)arena->bump.pos - (uintptr_t)arena->cur->memory);
+  for (mem_node *node = arena->large; node != NULL; node = node->next) {
+    used += node->used;
+  }
+  return used;
+}
+
+// Usage only grows between resets and rewinds, so it peaks right before them
+static void arena_update_high_water(arena_t *arena) {
+  size_t used = arena_used_bytes(arena);
+  if (used > arena->high_water) arena->high_water = used;
+}
+
 arena_t *arena_create(size_t size) {
   return arena_create_flags(size, ARENA_DEFAULT_FLAGS);
 }
 
 arena_t *arena_create_flags(size_t size, int flags) {
+  // Self-relative pointers only survive saving when everything is in one region
+  if ((flags & ARENA_RELOCATABLE) == ARENA_RELOCATABLE) flags |= ARENA_VIRTUAL;
+
   arena_t *new_arena = (arena_t *)malloc(sizeof(arena_t));
   if (new_arena == NULL) {
-    if ((flags & ARENA_PRINT_DEBUG) == ARENA_PRINT_DEBUG) printf("ARENA : Failed to allocate arena struct!\n");
     if ((flags & ARENA_EXIT_ON_ERROR) == ARENA_EXIT_ON_ERROR) exit(1);
     return NULL;
   }
-  new_arena->head = create_memory_node(size);
+  if ((flags & ARENA_VIRTUAL) == ARENA_VIRTUAL) {
+    new_arena->head = create_virtual_node(size, flags);
+  } else {
+    new_arena->head = create_memory_node(size, flags);
+  }
   if (new_arena->head == NULL) {
-    if ((flags & ARENA_PRINT_DEBUG) == ARENA_PRINT_DEBUG) printf("ARENA %lx : Failed to create initial arena memory node!\n", (uintptr_t)new_arena);
     free(new_arena);
     if ((flags & ARENA_EXIT_ON_ERROR) == ARENA_EXIT_ON_ERROR) exit(1);
     return NULL;
   }
   new_arena->flags = flags;
-  new_arena->cur = new_arena->head;
-  new_arena->pos = new_arena->cur->memory;
-  new_arena->size = size;
+  new_arena->growth = ARENA_DEFAULT_GROWTH;
+  new_arena->large = NULL;
+  new_arena->spare = NULL;
+  new_arena->defers = NULL;
+  new_arena->bump.allocs = 0;
+  new_arena->bump.padding = 0;
+  new_arena->stranded = 0;
+  new_arena->high_water = 0;
+  new_arena->decayed_high_water = 0;
+  new_arena->grow_count = 0;
+  new_arena->reset_policy = (flags & ARENA_VIRTUAL) == ARENA_VIRTUAL ? ARENA_RESET_RELEASE : ARENA_RESET_KEEP;
+  if ((flags & ARENA_PRINT_DEBUG) == ARENA_PRINT_DEBUG) {
+    new_arena->hook = arena_print_hook;
+    new_arena->hook_ctx = NULL;
+  } else {
+    new_arena->hook = default_hook;
+    new_arena->hook_ctx = default_hook_ctx;
+  }
+  arena_set_cur(new_arena, new_arena->head, new_arena->head->memory);
+  new_arena->size = new_arena->head->size;
+  new_arena->initial_size = new_arena->head->size;
   new_arena->used = 0;
 
+  arena_emit(new_arena, ARENA_EVENT_CREATE, new_arena->size, 0, new_arena->head->memory);
+
   return new_arena;
 }
 
+// Runs deferred callbacks until reaching `until`, which is kept
+static void arena_run_defers(arena_t *arena, defer_record *until) {
+  while (arena->defers != until) {
+    defer_record *record = arena->defers;
+    // Unlinked first, so callbacks may safely defer or reset themselves
+    arena->defers = record->prev;
+    record->fn(record->ctx);
+  }
+}
+
 void arena_free(arena_t *arena) {
-  if (FLAG_ENABLED(arena, ARENA_PRINT_DEBUG)) printf("ARENA %lx : Freeing!\n", (uintptr_t)arena);
+  arena_run_defers(arena, NULL);
+  arena_emit(arena, ARENA_EVENT_FREE, arena->size, 0, NULL);
   // First free memory nodes
-  for (mem_node *current = arena->head; current != NULL;) {
-    free(current->memory);
-    mem_node *prev = current;
-    current = current->next;
-    free(prev);
-  }
+  free_memory_nodes(arena->head);
+  free_memory_nodes(arena->large);
+  free_memory_nodes(arena->spare);
   free(arena);
   return;
 }
 
-static void *align_ptr(void *ptr, size_t align) {
-  uintptr_t addr = (uintptr_t)ptr;
-  uintptr_t aligned = (addr + align - 1) & ~(align - 1);
-  return (void*)aligned;
-}
-
 static bool is_power_of_2(size_t n) {
   return n > 0 && (n  & (n - 1)) == 0;
 }
 
-void *arena_alloc_aligned(arena_t *arena, size_t size, size_t align) {
+// Size of the node to grow into after `current`, following the growth schedule
+static size_t next_node_size(const arena_t *arena, const mem_node *current) {
+  const c_arena_growth_t *growth = &arena->growth;
+  double scaled = (double)current->size * growth->factor;
+  size_t next = scaled >= (double)SIZE_MAX ? SIZE_MAX : (size_t)scaled;
+  if (next < growth->min_node_size) next = growth->min_node_size;
+  if (growth->max_node_size != 0 && next > growth->max_node_size) next = growth->max_node_size;
+  return next;
+}
+
+// Worst case bytes a fresh node needs to fit `size` at `align`
+static size_t node_size_for(size_t size, size_t align) {
+  size_t padding = align > alignof(max_align_t) ? align - 1 : 0;
+  if (size > SIZE_MAX - padding) return SIZE_MAX;
+  return size + padding;
+}
+
+// Serves an oversized request from its own node, leaving the bump allocator where it is
+static void *arena_alloc_large(arena_t *arena, size_t size, size_t align) {
+  size_t node_size = node_size_for(size, align);
+  if (node_size == SIZE_MAX) return NULL;
+
+  // Reuse the smallest spare node that fits, so repeated cycles don't go back to the allocator
+  mem_node **best = NULL;
+  for (mem_node **link = &arena->spare; *link != NULL; link = &(*link)->next) {
+    if ((*link)->size >= node_size && (best == NULL || (*link)->size < (*best)->size)) best = link;
+  }
+
+  mem_node *node;
+  if (best != NULL) {
+    node = *best;
+    *best = node->next;
+  } else {
+    node = create_memory_node(node_size, arena->flags);
+    if (node == NULL) return NULL;
+    arena->size += node->size;
+    arena->grow_count++;
+    arena_emit(arena, ARENA_EVENT_GROW, node->size, 0, node->memory);
+  }
+
+  node->used = node->size;
+  node->next = arena->large;
+  arena->large = node;
+
+  uintptr_t aligned = ((uintptr_t)node->memory + align - 1) & ~(uintptr_t)(align - 1);
+  arena->bump.allocs++;
+  arena->bump.padding += aligned - (uintptr_t)node->memory;
+
+  return (void *)aligned;
+}
+
+// Moves through and grows the node chain until the request fits
+static void *arena_alloc_grow(arena_t *arena, size_t size, size_t align) {
+  for (;;) {
+    mem_node *current = arena->cur;
+
+    // Figure out where the allocation lands within the node
+    uintptr_t aligned = ((uintptr_t)arena->bump.pos + align - 1) & ~(uintptr_t)(align - 1);
+    size_t offset = aligned - (uintptr_t)current->memory;
+
+    // Check if we have space in the current mem_node
+    if (offset <= current->size && size <= current->size - offset) {
+      // Virtual arenas are a single contiguous reservation, commit pages as needed
+      if (FLAG_ENABLED(arena, ARENA_VIRTUAL) && !commit_virtual_node(current, offset + size, commit_granularity(arena))) return NULL;
+      arena->bump.allocs++;
+      arena->bump.padding += aligned - (uintptr_t)arena->bump.pos;
+      arena_set_cur(arena, current, (char *)aligned + size);
+      return (void *)aligned;
+    }
+
+    if (!FLAG_ENABLED(arena, ARENA_GROWABLE) || FLAG_ENABLED(arena, ARENA_VIRTUAL)) return NULL;
+
+    size_t extension = next_node_size(arena, current);
+    size_t threshold = arena->growth.large_threshold != 0 ? arena->growth.large_threshold : extension;
+    if (size > threshold) return arena_alloc_large(arena, size, align);
+
+    // As the arena can be reset, only create a node if we don't have a next one already
+    if (current->next == NULL) {
+      // Create a new mem_node, following the growth schedule
+      size_t required = node_size_for(size, align);
+      if (extension < required) extension = required;
+      mem_node *new_node = create_memory_node(extension, arena->flags);
+      if (new_node == NULL) return NULL;
+      current->next = new_node;
+      // Extend the arena size
+      arena->size += new_node->size;
+      arena->grow_count++;
+      arena_emit(arena, ARENA_EVENT_GROW, new_node->size, 0, new_node->memory);
+    }
+
+    // Signify we've used the entire block
+    arena->stranded += current->size - ((uintptr_t)arena->bump.pos - (uintptr_t)current->memory);
+    current->used = current->size;
+    arena->used += current->size;
+
+    // Move to the next block and try again
+    arena_set_cur(arena, current->next, current->next->memory);
+  }
+}
+
+void *arena_alloc_slow(arena_t *arena, size_t size, size_t align) {
   // Ensure it's a power of 2
   // Not doing ARENA_EXIT_ON_ERROR as it's a simple mis-use error
   if (!is_power_of_2(align)) { return NULL; }
 
-  if (FLAG_ENABLED(arena, ARENA_PRINT_DEBUG)) printf("ARENA %lx : Trying to assign %lu with %lu alignment\n", (uintptr_t)arena, size, align);
+  void *block = arena_alloc_grow(arena, size, align);
+  arena_emit(arena, ARENA_EVENT_ALLOC, size, align, block);
+  if (block == NULL && FLAG_ENABLED(arena, ARENA_EXIT_ON_ERROR)) exit(1);
+
+  return block;
+}
+
+void *arena_realloc(arena_t *arena, void *ptr, size_t old_size, size_t new_size) {
+  if (ptr == NULL) return arena_alloc(arena, new_size);
 
   mem_node *current = arena->cur;
+  uintptr_t start = (uintptr_t)ptr;
+  uintptr_t memory = (uintptr_t)current->memory;
 
-  // Figure out how much we need including alignment
-  void *aligned_arena_pos = align_ptr(arena->pos, align);
-  size_t padding_required = (uintptr_t)aligned_arena_pos - (uintptr_t)arena->pos;
-  size_t total_size_required = size + padding_required;
-   
-  // Check if we have space in the current mem_node
-  if (current->size < total_size_required + current->used) {
-    if (FLAG_ENABLED(arena, ARENA_PRINT_DEBUG)) printf("ARENA %lx : Not enough space!\n", (uintptr_t)arena);
-    if (!FLAG_ENABLED(arena, ARENA_GROWABLE)) {
-      if (FLAG_ENABLED(arena, ARENA_EXIT_ON_ERROR)) exit(1);
-      return NULL;
-    }
-    // AS the arena can be reset, check if we have a next node already.
-    if (current->next != NULL) {
-      if (FLAG_ENABLED(arena, ARENA_PRINT_DEBUG)) printf("ARENA %lx : Next node already exists!\n", (uintptr_t)arena);
-      // Signify we've used the entire block
-      arena->used += current->size - current->used;
-      current->used = current->size;
-
-      // Move to the next block
-      arena->cur = current->next;
-      arena->pos = arena->cur->memory;
-      if (FLAG_ENABLED(arena, ARENA_PRINT_DEBUG)) printf("ARENA %lx : Moved to next memory node!\n", (uintptr_t)arena);
-
-      // Try again
-      return arena_alloc_aligned(arena, size, align);
-    }
-    
-    if (FLAG_ENABLED(arena, ARENA_PRINT_DEBUG)) printf("ARENA %lx : Creating a new memory node!\n", (uintptr_t)arena);
-    // Create a new mem_node, twice the size
-    size_t extension = current->size*2;
-    mem_node *new_node = create_memory_node(extension);
-    if (new_node == NULL) {
-      if (FLAG_ENABLED(arena, ARENA_PRINT_DEBUG)) printf("ARENA %lx : Failed to create memory node", (uintptr_t)arena);
-      if (FLAG_ENABLED(arena, ARENA_EXIT_ON_ERROR)) exit(1);
-      return NULL;
+  // Only the last allocation in the current node can move the position
+  if (start >= memory && start - memory <= current->size && start + old_size == (uintptr_t)arena->bump.pos) {
+    size_t offset = start - memory;
+    if (new_size <= current->size - offset
+        && (!FLAG_ENABLED(arena, ARENA_VIRTUAL) || commit_virtual_node(current, offset + new_size, commit_granularity(arena)))) {
+      // Shrinking hands back bytes that were written, which the reset policy still has to cover
+      arena_sync_cur(arena);
+      rewind_node(current, offset + new_size);
+      arena_set_cur(arena, current, (char *)ptr + new_size);
+      arena_emit(arena, ARENA_EVENT_ALLOC, new_size, 1, ptr);
+      return ptr;
     }
+  }
+  // The tail can't be reclaimed, but there's no need to copy either
+  if (new_size <= old_size) return ptr;
 
-    if (FLAG_ENABLED(arena, ARENA_PRINT_DEBUG)) printf("ARENA %lx : Updating old memory node to suggest it's full\n", (uintptr_t)arena);
+  void *new_ptr = arena_alloc(arena, new_size);
+  if (new_ptr == NULL) return NULL;
+  memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
 
-    // Signify we've used the entire block
-    arena->used += current->size - current->used;
-    current->used = current->size;
-    // Extend the arena size
-    arena->size += extension;
+  return new_ptr;
+}
 
-    // Move to the next block
-    arena->cur->next = new_node;
-    arena->cur = new_node;
-    arena->pos = arena->cur->memory;
-    if (FLAG_ENABLED(arena, ARENA_PRINT_DEBUG)) printf("ARENA %lx : Moved to next memory node!\n", (uintptr_t)arena);
+static void *arena_allocator_alloc(void *ctx, size_t size) {
+  return arena_alloc((arena_t *)ctx, size);
+}
 
-    // Try again
-    return arena_alloc_aligned(arena, size, align);
-  }
+static void *arena_allocator_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size) {
+  return arena_realloc((arena_t *)ctx, ptr, old_size, new_size);
+}
+
+// Memory is only reclaimed by resetting or freeing the arena
+static void arena_allocator_free(void *ctx, void *ptr, size_t size) {
+  (void)ctx;
+  (void)ptr;
+  (void)size;
+}
 
-  // Save the pointer before moving it
-  arena->pos += total_size_required;
-  arena->used += total_size_required;
-  arena->cur->used += total_size_required;
+c_allocator_t arena_allocator(arena_t *arena) {
+  return (c_allocator_t){
+    .alloc = arena_allocator_alloc,
+    .realloc = arena_allocator_realloc,
+    .free = arena_allocator_free,
+    .ctx = arena,
+  };
+}
+
+// Resizes a reset chain to roughly `retain` bytes, coalesced into one node where possible.
+// Only adaptive sizing may grow the chain, since `retain` then includes dedicated-node usage
+static void arena_trim_chain(arena_t *arena, size_t retain, bool may_grow) {
+  // Spare dedicated nodes aren't part of what's retained
+  free_spare_nodes(arena);
+
+  mem_node *head = arena->head;
+
+  size_t chain = 0;
+  for (mem_node *node = head; node != NULL; node = node->next) chain += node->size;
+
+  // The initial size is the floor, and an explicit retain has nothing to gain by growing
+  size_t keep = retain > arena->initial_size ? retain : arena->initial_size;
+  if (!may_grow && keep > chain) keep = chain;
+  // Usage excludes trailing alignment padding, so leave grown nodes a page of slack
+  if (keep > chain) keep = round_up(keep, page_size());
+
+  // A lone node big enough is only worth replacing when at least half of it would go
+  if (head->next == NULL && keep <= head->size && head->size / 2 < keep) return;
+
+  if (keep != head->size) {
+    mem_node *merged = create_memory_node(keep, arena->flags);
+    if (merged != NULL) {
+      free_memory_nodes(head);
+      arena->head = merged;
+      arena->size = arena->size - chain + merged->size;
+      arena->grow_count++;
+      arena_set_cur(arena, merged, merged->memory);
+      arena_emit(arena, ARENA_EVENT_GROW, merged->size, 0, merged->memory);
+      return;
+    }
+  }
 
-  return aligned_arena_pos;
+  // Otherwise just drop the nodes past what's retained
+  mem_node *last = head;
+  size_t kept = head->size;
+  while (last->next != NULL && kept + last->next->size <= keep) {
+    last = last->next;
+    kept += last->size;
+  }
+  free_memory_nodes(last->next);
+  last->next = NULL;
+  arena->size = arena->size - chain + kept;
 }
 
-void *arena_alloc(arena_t *arena, size_t size) {
-  return arena_alloc_aligned(arena, size, alignof(max_align_t));
+// Applies the reset policy to everything written in a node since the last reset
+static void arena_reset_node(arena_t *arena, mem_node *node) {
+  if (node->dirty > node->used) node->used = node->dirty;
+  switch (arena->reset_policy) {
+    case ARENA_RESET_KEEP:
+      break;
+    case ARENA_RESET_ZERO_USED:
+      memset(node->memory, 0, node->used);
+      break;
+    case ARENA_RESET_RELEASE:
+      if (FLAG_ENABLED(arena, ARENA_VIRTUAL)) {
+        decommit_virtual_node(node, 0);
+      } else {
+        release_heap_node(node);
+      }
+      break;
+  }
+  node->used = 0;
+  node->dirty = 0;
 }
 
 void arena_reset(arena_t *arena) {
+  arena_run_defers(arena, NULL);
+
+  size_t used = arena_used_bytes(arena);
+  if (used > arena->high_water) arena->high_water = used;
+  // Follows usage up immediately, but only falls back slowly
+  size_t decayed = arena->decayed_high_water - (arena->decayed_high_water >> ARENA_DECAY_SHIFT);
+  arena->decayed_high_water = used > decayed ? used : decayed;
+
+  arena_sync_cur(arena);
+
   // Reset the backing memory nodes
   for (mem_node *cur = arena->head; cur != NULL; cur = cur->next) {
-    memset(cur->memory, 0, cur->size);
-    cur->used = 0;
+    // Nodes past the furthest one reached have not been touched since the last reset
+    if (cur->used == 0 && cur->dirty == 0) continue;
+    arena_reset_node(arena, cur);
   }
 
+  // Dedicated nodes are kept for the next cycle's requests, including those rewound since
+  for (mem_node *cur = arena->large; cur != NULL; cur = cur->next) {
+    arena_reset_node(arena, cur);
+  }
+  for (mem_node *cur = arena->spare; cur != NULL; cur = cur->next) {
+    if (cur->used != 0) arena_reset_node(arena, cur);
+  }
+  retire_large_nodes(arena, NULL);
+
   // Set pointer back to the very start
-  arena->pos = arena->head->memory;
-  arena->cur = arena->head;
+  arena_set_cur(arena, arena->head, arena->head->memory);
 
   // Reset arena metadata
   arena->used = 0;
 
-  if (FLAG_ENABLED(arena, ARENA_PRINT_DEBUG)) printf("ARENA %lx : Reset!\n", (uintptr_t)arena);
+  arena_emit(arena, ARENA_EVENT_RESET, arena->size, 0, NULL);
+
+  // Coalesce into a node the recent cycles fit in, so the next one needn't chain
+  if (FLAG_ENABLED(arena, ARENA_ADAPTIVE) && !FLAG_ENABLED(arena, ARENA_VIRTUAL)) {
+    arena_trim_chain(arena, arena->decayed_high_water, true);
+  }
+}
+
+// Clears a failed batch, which the fast path may have set some pointers of before falling back
+static int arena_alloc_many_fail(c_arena_block_t *blocks, size_t count) {
+  for (size_t i = 0; i < count; i++) blocks[i].ptr = NULL;
+  return -1;
+}
+
+int arena_alloc_many_slow(arena_t *arena, c_arena_block_t *blocks, size_t count) {
+  // Size a base aligned for the strictest of the blocks
+  size_t max_align = 1;
+  size_t total = 0;
+  for (size_t i = 0; i < count; i++) {
+    size_t align = blocks[i].align;
+    if (!is_power_of_2(align)) return arena_alloc_many_fail(blocks, count);
+    if (align > max_align) max_align = align;
+    size_t offset = round_up(total, align);
+    if (offset < total || blocks[i].size > SIZE_MAX - offset) return arena_alloc_many_fail(blocks, count);
+    total = offset + blocks[i].size;
+  }
+
+  char *base = arena_alloc_aligned(arena, total, max_align);
+  if (base == NULL) return arena_alloc_many_fail(blocks, count);
+
+  // Only hand out pointers once the whole batch is committed
+  size_t offset = 0;
+  for (size_t i = 0; i < count; i++) {
+    offset = round_up(offset, blocks[i].align);
+    blocks[i].ptr = base + offset;
+    offset += blocks[i].size;
+  }
+  return 0;
+}
+
+int arena_defer(arena_t *arena, c_arena_defer_t fn, void *ctx) {
+  defer_record *record = arena_alloc_aligned(arena, sizeof(defer_record), alignof(defer_record));
+  if (record == NULL) return -1;
+  record->fn = fn;
+  record->ctx = ctx;
+  record->prev = arena->defers;
+  arena->defers = record;
+  return 0;
+}
+
+void arena_reset_retain(arena_t *arena, size_t retain) {
+  arena_reset(arena);
+
+  if (retain == ARENA_RETAIN_DECAYED) retain = arena->decayed_high_water;
+
+  if (FLAG_ENABLED(arena, ARENA_VIRTUAL)) {
+    decommit_virtual_node(arena->head, retain);
+    arena_set_cur(arena, arena->head, arena->head->memory);
+    return;
+  }
+  arena_trim_chain(arena, retain, false);
+}
+
+void arena_set_reset_policy(arena_t *arena, c_arena_reset_policy_t policy) {
+  arena->reset_policy = policy;
+}
+
+int arena_set_growth(arena_t *arena, c_arena_growth_t growth) {
+  if (!(growth.factor >= 1.0)) return -1;
+  if (growth.max_node_size != 0 && growth.max_node_size < growth.min_node_size) return -1;
+  arena->growth = growth;
+  return 0;
+}
+
+c_arena_mark_t arena_mark(const arena_t *arena) {
+  return (c_arena_mark_t){
+    .node = arena->cur,
+    .pos = arena->bump.pos,
+    .used = arena->used,
+    .large = arena->large,
+    .defers = arena->defers,
+  };
+}
+
+void arena_rewind(arena_t *arena, c_arena_mark_t mark) {
+  arena_run_defers(arena, (defer_record *)mark.defers);
+  arena_update_high_water(arena);
+  retire_large_nodes(arena, (mem_node *)mark.large);
+  arena_sync_cur(arena);
+
+  mem_node *node = (mem_node *)mark.node;
+
+  // Any nodes moved into since the mark are handed back, still dirty for the reset policy
+  while (node != arena->cur) {
+    node = node->next;
+    rewind_node(node, 0);
+  }
+
+  node = (mem_node *)mark.node;
+  rewind_node(node, (uintptr_t)mark.pos - (uintptr_t)node->memory);
+  arena_set_cur(arena, node, mark.pos);
+  arena->used = mark.used;
+
+  arena_emit(arena, ARENA_EVENT_REWIND, arena_used_bytes(arena), 0, mark.pos);
+}
+
+void arena_set_hook(arena_t *arena, c_arena_hook_t hook, void *ctx) {
+  arena->hook = hook;
+  arena->hook_ctx = ctx;
+  // Re-evaluates whether the fast path may be taken
+  arena_set_cur(arena, arena->cur, arena->bump.pos);
+}
+
+void arena_set_default_hook(c_arena_hook_t hook, void *ctx) {
+  default_hook = hook;
+  default_hook_ctx = ctx;
+}
+
+c_arena_stats_t arena_stats(const arena_t *arena) {
+  c_arena_stats_t stats = {
+    .reserved = arena->size,
+    .used = arena_used_bytes(arena),
+    .high_water = arena->high_water,
+    .padding = arena->bump.padding,
+    .stranded = arena->stranded,
+    .alloc_count = arena->bump.allocs,
+    .grow_count = arena->grow_count,
+  };
+  if (stats.used > stats.high_water) stats.high_water = stats.used;
+
+  for (mem_node *node = arena->head; node != NULL; node = node->next) {
+    stats.node_count++;
+    stats.committed += node->committed;
+  }
+  for (mem_node *node = arena->large; node != NULL; node = node->next) {
+    stats.node_count++;
+    stats.committed += node->committed;
+  }
+  for (mem_node *node = arena->spare; node != NULL; node = node->next) {
+    stats.node_count++;
+    stats.committed += node->committed;
+  }
+
+  return stats;
+}
+
+int arena_save(const arena_t *arena, const void *root, const char *path) {
+  if (!FLAG_ENABLED(arena, ARENA_RELOCATABLE)) return -1;
+
+  // A relocatable arena is one contiguous region, used up to its position
+  const char *memory = arena->head->memory;
+  size_t size = (uintptr_t)arena->bump.pos - (uintptr_t)memory;
+  if ((const char *)root < memory || (const char *)root >= memory + size) return -1;
+
+  char header[ARENA_IMAGE_HEADER_SIZE] = {0};
+  image_header fields = { .size = size, .root = (uintptr_t)root - (uintptr_t)memory };
+  memcpy(fields.magic, ARENA_IMAGE_MAGIC, sizeof(fields.magic));
+  memcpy(header, &fields, sizeof(fields));
+
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) return -1;
+  bool written = fwrite(header, 1, sizeof(header), file) == sizeof(header)
+    && fwrite(memory, 1, size, file) == size;
+  if (fclose(file) != 0 || !written) {
+    remove(path);
+    return -1;
+  }
+
+  return 0;
+}
+
+arena_image_t *arena_load(const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return NULL;
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || (size_t)info.st_size < ARENA_IMAGE_HEADER_SIZE) {
+    close(fd);
+    return NULL;
+  }
+  size_t map_size = (size_t)info.st_size;
+  void *map = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps its own reference to the file
+  close(fd);
+  if (map == MAP_FAILED) return NULL;
+
+  image_header header;
+  memcpy(&header, map, sizeof(header));
+  if (memcmp(header.magic, ARENA_IMAGE_MAGIC, sizeof(header.magic)) != 0
+      || header.size > map_size - ARENA_IMAGE_HEADER_SIZE || header.root >= header.size) {
+    munmap(map, map_size);
+    return NULL;
+  }
+
+  arena_image_t *image = (arena_image_t *)malloc(sizeof(arena_image_t));
+  if (image == NULL) {
+    munmap(map, map_size);
+    return NULL;
+  }
+  image->map = map;
+  image->map_size = map_size;
+  image->memory = (const char *)map + ARENA_IMAGE_HEADER_SIZE;
+  image->size = header.size;
+  image->root = header.root;
+
+  return image;
+}
+
+const void *arena_image_root(const arena_image_t *image) {
+  return image->memory + image->root;
+}
+
+size_t arena_image_size(const arena_image_t *image) {
+  return image->size;
+}
+
+void arena_image_free(arena_image_t *image) {
+  munmap(image->map, image->map_size);
+  free(image);
 }
@@ -0,0 +1,112 @@
+#define _GNU_SOURCE
+#include "../include/collections/carena.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+// Leases are rounded to cache lines so threads never share one
+#define CARENA_LEASE_ALIGN ((size_t)64)
+
+typedef c_carena_t carena_t;
+
+struct carena_t {
+  char *memory; // 8
+  size_t reserve; // 8
+  size_t chunk_size; // 8
+  alignas(CARENA_LEASE_ALIGN) atomic_size_t offset; // 8 - Own cache line, as every thread hits it
+};
+
+static size_t round_up(size_t n, size_t multiple) {
+  return (n + multiple - 1) / multiple * multiple;
+}
+
+static bool is_power_of_2(size_t n) {
+  return n > 0 && (n  & (n - 1)) == 0;
+}
+
+carena_t *carena_create(size_t reserve, size_t chunk_size) {
+  if (reserve == 0 || chunk_size == 0) return NULL;
+
+  carena_t *arena = (carena_t *)aligned_alloc(alignof(carena_t), sizeof(carena_t));
+  if (arena == NULL) return NULL;
+
+  reserve = round_up(reserve, CARENA_LEASE_ALIGN);
+  arena->memory = mmap(NULL, reserve, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (arena->memory == MAP_FAILED) {
+    free(arena);
+    return NULL;
+  }
+  arena->reserve = reserve;
+  arena->chunk_size = round_up(chunk_size, CARENA_LEASE_ALIGN);
+  atomic_init(&arena->offset, 0);
+
+  return arena;
+}
+
+void carena_free(carena_t *arena) {
+  if (arena == NULL) return;
+  munmap(arena->memory, arena->reserve);
+  free(arena);
+}
+
+void carena_reset(carena_t *arena) {
+  atomic_store_explicit(&arena->offset, 0, memory_order_relaxed);
+}
+
+// The only point of contention between threads
+static char *carena_lease_chunk(carena_t *arena, size_t size) {
+  // The reservation is a multiple of the lease alignment, so rounding can't wrap past it
+  if (size > arena->reserve) return NULL;
+  size = round_up(size, CARENA_LEASE_ALIGN);
+
+  // Only advances when the chunk fits, so a failed lease doesn't strand the rest of the arena
+  size_t offset = atomic_load_explicit(&arena->offset, memory_order_relaxed);
+  do {
+    if (arena->reserve - offset < size) return NULL;
+  } while (!atomic_compare_exchange_weak_explicit(&arena->offset, &offset, offset + size,
+                                                  memory_order_relaxed, memory_order_relaxed));
+
+  return arena->memory + offset;
+}
+
+c_carena_lease_t carena_lease_init(carena_t *arena) {
+  return (c_carena_lease_t){
+    .arena = arena,
+    .pos = NULL,
+    .end = NULL,
+  };
+}
+
+void *carena_alloc(c_carena_lease_t *lease, size_t size, size_t align) {
+  if (!is_power_of_2(align)) return NULL;
+
+  uintptr_t aligned = ((uintptr_t)lease->pos + align - 1) & ~(align - 1);
+  if (lease->pos != NULL && aligned <= (uintptr_t)lease->end && size <= (uintptr_t)lease->end - aligned) {
+    lease->pos = (char *)aligned + size;
+    return (void *)aligned;
+  }
+
+  carena_t *arena = lease->arena;
+  if (size > arena->reserve) return NULL;
+  size_t required = size + (align > CARENA_LEASE_ALIGN ? align : 0);
+
+  // Too big to share a chunk, give it its own lease and keep the current one
+  if (required > arena->chunk_size / 2) {
+    char *block = carena_lease_chunk(arena, required);
+    if (block == NULL) return NULL;
+    return (void *)(((uintptr_t)block + align - 1) & ~(align - 1));
+  }
+
+  char *chunk = carena_lease_chunk(arena, arena->chunk_size);
+  if (chunk == NULL) return NULL;
+  lease->end = chunk + arena->chunk_size;
+  aligned = ((uintptr_t)chunk + align - 1) & ~(align - 1);
+  lease->pos = (char *)aligned + size;
+
+  return (void *)aligned;
+}
+
+size_t carena_used(const carena_t *arena) {
+  return atomic_load_explicit(&arena->offset, memory_order_relaxed);
+}
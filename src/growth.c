@@ -0,0 +1,25 @@
+#include "../include/collections/growth.h"
+
+#include <stdint.h>
+
+bool growth_policy_valid(const c_growth_policy_t *policy) {
+  return policy->factor == 0 || policy->factor >= 1.0;
+}
+
+size_t growth_policy_next(const c_growth_policy_t *policy, size_t capacity, size_t required, size_t builtin) {
+  size_t next = builtin;
+  if (policy->custom != NULL) {
+    next = policy->custom(capacity, required, policy->ctx);
+  } else if (policy->factor != 0) {
+    double scaled = (double)capacity * policy->factor;
+    next = scaled >= (double)SIZE_MAX ? SIZE_MAX : (size_t)scaled;
+  }
+
+  // Whatever the schedule says, always make progress
+  size_t step = policy->min_step > 0 ? policy->min_step : 1;
+  size_t stepped = capacity > SIZE_MAX - step ? SIZE_MAX : capacity + step;
+  if (next < stepped) next = stepped;
+  if (next < required) next = required;
+
+  return next;
+}
@@ -17,10 +17,18 @@ struct parray_t {
   size_t length; // 8
   size_t allocation_size; // 8
   void (*parray_free_func)(void*);
+  c_allocator_t allocator; // 32
+  c_growth_policy_t growth; // 32
 };
 
 parray_t *parray_create(void (*parray_free_func)(void*)) {
-  parray_t *new_arr = (parray_t *)malloc(sizeof(parray_t));
+  return parray_create_with_allocator(parray_free_func, NULL);
+}
+
+parray_t *parray_create_with_allocator(void (*parray_free_func)(void*), const c_allocator_t *allocator) {
+  c_allocator_t alloc = allocator != NULL ? *allocator : allocator_default();
+
+  parray_t *new_arr = (parray_t *)alloc.alloc(alloc.ctx, sizeof(parray_t));
   if (new_arr == NULL) {
     return NULL;
   }
@@ -28,9 +36,9 @@ parray_t *parray_create(void (*parray_free_func)(void*)) {
   size_t over_allocation = CALCULATE_RESIZE(0);
 
   // Just storing pointers
-  new_arr->items = malloc(sizeof(void *) * over_allocation);
+  new_arr->items = alloc.alloc(alloc.ctx, sizeof(void *) * over_allocation);
   if (new_arr->items == NULL) {
-    free(new_arr);
+    alloc.free(alloc.ctx, new_arr, sizeof(parray_t));
     return NULL;
   }
   memset(new_arr->items, 0, sizeof(void*) * over_allocation);
@@ -38,6 +46,8 @@ parray_t *parray_create(void (*parray_free_func)(void*)) {
   new_arr->length = 0;
   new_arr->allocation_size = over_allocation;
   new_arr->parray_free_func = parray_free_func;
+  new_arr->allocator = alloc;
+  new_arr->growth = GROWTH_POLICY_DEFAULT;
 
   return new_arr;
 }
@@ -48,13 +58,17 @@ void parray_free(parray_t *parray) {
       parray->parray_free_func(parray->items[i]);
     }
   }
-  free(parray->items);
-  free(parray);
+  c_allocator_t alloc = parray->allocator;
+  alloc.free(alloc.ctx, parray->items, sizeof(void*) * parray->allocation_size);
+  alloc.free(alloc.ctx, parray, sizeof(parray_t));
 }
 
 static int __parray_grow(parray_t *parray) {
-  size_t new_capacity = CALCULATE_RESIZE(parray->allocation_size);
-  void **new_items = realloc(parray->items, sizeof(void*) * new_capacity);
+  size_t new_capacity = growth_policy_next(&parray->growth, parray->allocation_size, parray->length + 1,
+                                           CALCULATE_RESIZE(parray->allocation_size));
+  if (new_capacity > SIZE_MAX / sizeof(void*)) return -1;
+  void **new_items = parray->allocator.realloc(parray->allocator.ctx, parray->items,
+                                              sizeof(void*) * parray->allocation_size, sizeof(void*) * new_capacity);
   if (new_items == NULL) return -1;
   parray->items = new_items;
   memset(&parray->items[parray->allocation_size], 0, sizeof(void*) * (new_capacity - parray->allocation_size));
@@ -133,3 +147,23 @@ void *parray_pop(parray_t *parray, size_t index) {
 
   return to_remove;
 }
+
+int parray_shrink_to_fit(parray_t *parray) {
+  // Keeps room for one item, so the memory is never released outright
+  size_t new_capacity = parray->length > 0 ? parray->length : 1;
+  if (new_capacity >= parray->allocation_size) return 0;
+
+  void **new_items = parray->allocator.realloc(parray->allocator.ctx, parray->items,
+                                              sizeof(void*) * parray->allocation_size, sizeof(void*) * new_capacity);
+  if (new_items == NULL) return -1;
+  parray->items = new_items;
+  parray->allocation_size = new_capacity;
+
+  return 0;
+}
+
+int parray_set_growth(parray_t *parray, c_growth_policy_t policy) {
+  if (!growth_policy_valid(&policy)) return -1;
+  parray->growth = policy;
+  return 0;
+}
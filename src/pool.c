@@ -0,0 +1,82 @@
+#include "../include/collections/pool.h"
+
+typedef c_pool_t pool_t;
+
+// Released objects hold the link to the next free object in their own memory
+typedef struct free_obj free_obj;
+struct free_obj {
+  free_obj *next;
+};
+
+struct pool_t {
+  c_arena_t *arena; // 8
+  free_obj *free_list; // 8
+  char *slab_pos; // 8 - Next never handed out object in the current slab
+  char *slab_end; // 8
+  size_t obj_size; // 8
+  size_t stride; // 8
+  size_t align; // 8
+  size_t slab_bytes; // 8
+};
+
+static size_t round_up(size_t n, size_t multiple) {
+  return (n + multiple - 1) / multiple * multiple;
+}
+
+pool_t *pool_create(c_arena_t *arena, size_t obj_size) {
+  if (arena == NULL || obj_size == 0) return NULL;
+
+  pool_t *pool = (pool_t *)arena_alloc_aligned(arena, sizeof(pool_t), alignof(pool_t));
+  if (pool == NULL) return NULL;
+
+  // Every object must be able to hold a free list link
+  size_t size = obj_size < sizeof(free_obj) ? sizeof(free_obj) : obj_size;
+  size_t align = sizeof(free_obj);
+  while (align < size && align < alignof(max_align_t)) align *= 2;
+
+  pool->arena = arena;
+  pool->free_list = NULL;
+  pool->slab_pos = NULL;
+  pool->slab_end = NULL;
+  pool->obj_size = obj_size;
+  pool->align = align;
+  pool->stride = round_up(size, align);
+  // Big objects still get several per slab
+  pool->slab_bytes = pool->stride * 8 > POOL_SLAB_SIZE ? pool->stride * 8 : round_up(POOL_SLAB_SIZE, pool->stride);
+
+  return pool;
+}
+
+// Objects are carved out of slabs lazily, rather than threading a whole slab onto the free list
+static void *pool_alloc_slab(pool_t *pool) {
+  char *slab = (char *)arena_alloc_aligned(pool->arena, pool->slab_bytes, pool->align);
+  if (slab == NULL) return NULL;
+  pool->slab_pos = slab + pool->stride;
+  pool->slab_end = slab + pool->slab_bytes;
+  return slab;
+}
+
+void *pool_alloc(pool_t *pool) {
+  if (pool->free_list != NULL) {
+    free_obj *obj = pool->free_list;
+    pool->free_list = obj->next;
+    return obj;
+  }
+  if (pool->slab_pos != pool->slab_end) {
+    void *obj = pool->slab_pos;
+    pool->slab_pos += pool->stride;
+    return obj;
+  }
+  return pool_alloc_slab(pool);
+}
+
+void pool_release(pool_t *pool, void *obj) {
+  if (obj == NULL) return;
+  free_obj *released = (free_obj *)obj;
+  released->next = pool->free_list;
+  pool->free_list = released;
+}
+
+size_t pool_obj_size(const pool_t *pool) {
+  return pool->obj_size;
+}
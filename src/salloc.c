@@ -0,0 +1,123 @@
+#include "../include/collections/salloc.h"
+#include "../include/collections/pool.h"
+
+// 16, 32, ... 4096
+#define SALLOC_CLASS_COUNT 9
+
+typedef c_salloc_t salloc_t;
+
+// Sits in front of every block, padded to keep blocks maximally aligned
+typedef union {
+  size_t capacity;
+  max_align_t align;
+} block_header;
+
+struct salloc_t {
+  c_arena_t *arena; // 8
+  c_pool_t *pools[SALLOC_CLASS_COUNT]; // 72 - Created on first use of each class
+};
+
+salloc_t *salloc_create(c_arena_t *arena) {
+  if (arena == NULL) return NULL;
+
+  salloc_t *salloc = (salloc_t *)arena_alloc_aligned(arena, sizeof(salloc_t), alignof(salloc_t));
+  if (salloc == NULL) return NULL;
+  salloc->arena = arena;
+  for (size_t i = 0; i < SALLOC_CLASS_COUNT; i++) {
+    salloc->pools[i] = NULL;
+  }
+
+  return salloc;
+}
+
+// Index of the smallest class holding `size` bytes, which must be at most SALLOC_MAX_CLASS
+static size_t class_index(size_t size) {
+  size_t index = 0;
+  size_t capacity = SALLOC_MIN_CLASS;
+  while (capacity < size) {
+    capacity *= 2;
+    index++;
+  }
+  return index;
+}
+
+static block_header *header_of(const void *ptr) {
+  return (block_header *)ptr - 1;
+}
+
+void *salloc_alloc(salloc_t *salloc, size_t size) {
+  block_header *header;
+  size_t capacity;
+
+  if (size > SALLOC_MAX_CLASS) {
+    if (size > SIZE_MAX - sizeof(block_header)) return NULL;
+    capacity = size;
+    header = (block_header *)arena_alloc(salloc->arena, sizeof(block_header) + size);
+  } else {
+    size_t index = class_index(size);
+    capacity = (size_t)SALLOC_MIN_CLASS << index;
+    if (salloc->pools[index] == NULL) {
+      salloc->pools[index] = pool_create(salloc->arena, sizeof(block_header) + capacity);
+      if (salloc->pools[index] == NULL) return NULL;
+    }
+    header = (block_header *)pool_alloc(salloc->pools[index]);
+  }
+  if (header == NULL) return NULL;
+
+  header->capacity = capacity;
+  return header + 1;
+}
+
+void salloc_free(salloc_t *salloc, void *ptr) {
+  if (ptr == NULL) return;
+  block_header *header = header_of(ptr);
+  // Large blocks are reclaimed along with the arena
+  if (header->capacity > SALLOC_MAX_CLASS) return;
+  pool_release(salloc->pools[class_index(header->capacity)], header);
+}
+
+void *salloc_realloc(salloc_t *salloc, void *ptr, size_t size) {
+  if (ptr == NULL) return salloc_alloc(salloc, size);
+  if (size == 0) {
+    salloc_free(salloc, ptr);
+    return NULL;
+  }
+
+  size_t capacity = header_of(ptr)->capacity;
+  // Still fits, and isn't worth moving down to a smaller class
+  if (size <= capacity && (capacity <= SALLOC_MIN_CLASS || size > capacity / 2)) return ptr;
+
+  void *new_ptr = salloc_alloc(salloc, size);
+  if (new_ptr == NULL) return NULL;
+  memcpy(new_ptr, ptr, size < capacity ? size : capacity);
+  salloc_free(salloc, ptr);
+
+  return new_ptr;
+}
+
+size_t salloc_usable_size(const void *ptr) {
+  return header_of(ptr)->capacity;
+}
+
+static void *salloc_allocator_alloc(void *ctx, size_t size) {
+  return salloc_alloc((salloc_t *)ctx, size);
+}
+
+static void *salloc_allocator_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size) {
+  (void)old_size;
+  return salloc_realloc((salloc_t *)ctx, ptr, new_size);
+}
+
+static void salloc_allocator_free(void *ctx, void *ptr, size_t size) {
+  (void)size;
+  salloc_free((salloc_t *)ctx, ptr);
+}
+
+c_allocator_t salloc_allocator(salloc_t *salloc) {
+  return (c_allocator_t){
+    .alloc = salloc_allocator_alloc,
+    .realloc = salloc_allocator_realloc,
+    .free = salloc_allocator_free,
+    .ctx = salloc,
+  };
+}
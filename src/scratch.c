@@ -0,0 +1,62 @@
+#include <pthread.h>
+#include "../include/collections/scratch.h"
+
+// Each thread gets its own pool, so no synchronisation is required
+static _Thread_local c_arena_t *scratch_pool[SCRATCH_POOL_COUNT];
+
+// Frees a thread's pool when it exits, holding the pool as its value
+static pthread_key_t scratch_key;
+static pthread_once_t scratch_key_once = PTHREAD_ONCE_INIT;
+static bool scratch_key_created = false;
+
+static void scratch_pool_free(c_arena_t **pool) {
+  for (size_t i = 0; i < SCRATCH_POOL_COUNT; i++) {
+    if (pool[i] == NULL) continue;
+    arena_free(pool[i]);
+    pool[i] = NULL;
+  }
+}
+
+static void scratch_thread_exit(void *pool) {
+  scratch_pool_free((c_arena_t **)pool);
+}
+
+static void scratch_key_create(void) {
+  scratch_key_created = pthread_key_create(&scratch_key, scratch_thread_exit) == 0;
+}
+
+static bool is_conflicting(const c_arena_t *arena, c_arena_t *const *conflicts, size_t conflict_count) {
+  for (size_t i = 0; i < conflict_count; i++) {
+    if (conflicts[i] == arena) return true;
+  }
+  return false;
+}
+
+c_scratch_t scratch_begin(c_arena_t *const *conflicts, size_t conflict_count) {
+  for (size_t i = 0; i < SCRATCH_POOL_COUNT; i++) {
+    if (scratch_pool[i] == NULL) {
+      scratch_pool[i] = arena_create_flags(SCRATCH_ARENA_SIZE, ARENA_GROWABLE);
+      if (scratch_pool[i] == NULL) break;
+      // The first arena a thread creates registers the pool to be freed on exit
+      pthread_once(&scratch_key_once, scratch_key_create);
+      if (scratch_key_created) pthread_setspecific(scratch_key, scratch_pool);
+    }
+    if (is_conflicting(scratch_pool[i], conflicts, conflict_count)) continue;
+
+    return (c_scratch_t){
+      .arena = scratch_pool[i],
+      .mark = arena_mark(scratch_pool[i]),
+    };
+  }
+
+  return (c_scratch_t){ .arena = NULL };
+}
+
+void scratch_end(c_scratch_t scratch) {
+  if (scratch.arena == NULL) return;
+  arena_rewind(scratch.arena, scratch.mark);
+}
+
+void scratch_thread_free(void) {
+  scratch_pool_free(scratch_pool);
+}
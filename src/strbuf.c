@@ -0,0 +1,91 @@
+#include "../include/collections/strbuf.h"
+
+#include <stdarg.h>
+
+void strbuf_init(c_strbuf_t *buf, c_arena_t *arena) {
+  buf->arena = arena;
+  buf->data = NULL;
+  buf->len = 0;
+  buf->cap = 0;
+}
+
+// Makes room for `extra` more bytes plus the NUL terminator
+static bool strbuf_reserve(c_strbuf_t *buf, size_t extra) {
+  if (extra >= SIZE_MAX - buf->len) return false;
+  size_t required = buf->len + extra + 1;
+  if (required <= buf->cap) return true;
+
+  if (buf->data == NULL) {
+    size_t cap = required > STRBUF_INITIAL_CAP ? required : STRBUF_INITIAL_CAP;
+    char *data = (char *)arena_alloc_aligned(buf->arena, cap, 1);
+    if (data == NULL) return false;
+    buf->data = data;
+    buf->cap = cap;
+    return true;
+  }
+
+  // Doubling keeps appends amortised constant when the buffer has to move
+  size_t cap = buf->cap > SIZE_MAX / 2 ? SIZE_MAX : buf->cap * 2;
+  if (cap < required) cap = required;
+  char *data = (char *)arena_realloc(buf->arena, buf->data, buf->cap, cap);
+  if (data == NULL) return false;
+  buf->data = data;
+  buf->cap = cap;
+
+  return true;
+}
+
+bool strbuf_append(c_strbuf_t *buf, const char *str, size_t len) {
+  if (!strbuf_reserve(buf, len)) return false;
+  memcpy(buf->data + buf->len, str, len);
+  buf->len += len;
+  return true;
+}
+
+bool strbuf_append_cstr(c_strbuf_t *buf, const char *str) {
+  return strbuf_append(buf, str, strlen(str));
+}
+
+bool strbuf_append_char(c_strbuf_t *buf, char c) {
+  if (!strbuf_reserve(buf, 1)) return false;
+  buf->data[buf->len++] = c;
+  return true;
+}
+
+bool strbuf_appendf(c_strbuf_t *buf, const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  // Try formatting into the spare capacity first, only measuring when it doesn't fit
+  size_t spare = buf->cap > buf->len ? buf->cap - buf->len : 0;
+  int written = vsnprintf(spare > 0 ? buf->data + buf->len : NULL, spare, fmt, args);
+  va_end(args);
+  if (written < 0) return false;
+  if ((size_t)written < spare) {
+    buf->len += (size_t)written;
+    return true;
+  }
+
+  if (!strbuf_reserve(buf, (size_t)written)) return false;
+  va_start(args, fmt);
+  vsnprintf(buf->data + buf->len, (size_t)written + 1, fmt, args);
+  va_end(args);
+  buf->len += (size_t)written;
+
+  return true;
+}
+
+size_t strbuf_len(const c_strbuf_t *buf) {
+  return buf->len;
+}
+
+c_str_t strbuf_finish(c_strbuf_t *buf) {
+  if (!strbuf_reserve(buf, 0)) return (c_str_t){ .ptr = NULL, .len = 0 };
+  buf->data[buf->len] = '\0';
+  // Shrinks in place when nothing was allocated after the buffer
+  arena_realloc(buf->arena, buf->data, buf->cap, buf->len + 1);
+  c_str_t str = { .ptr = buf->data, .len = buf->len };
+
+  strbuf_init(buf, buf->arena);
+
+  return str;
+}
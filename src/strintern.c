@@ -0,0 +1,206 @@
+#include "../include/collections/strintern.h"
+
+#define STRINTERN_INITIAL_SLOTS 64
+
+typedef c_strintern_t strintern_t;
+
+// Slots keep the hash next to the id, so most probes never touch the strings
+typedef struct {
+  uint32_t hash; // 4
+  uint32_t id; // 4 - `STRINTERN_INVALID` when empty
+} slot;
+
+struct strintern_t {
+  c_arena_t *arena; // 8
+  slot *slots; // 8
+  c_str_t *entries; // 8 - Indexed by id
+  size_t count; // 8
+  size_t entry_cap; // 8
+  size_t mask; // 8 - Slot count minus one, slot count is a power of 2
+};
+
+static const uint64_t wy_secret[4] = {
+  0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull,
+};
+
+static inline void wy_mum(uint64_t *a, uint64_t *b) {
+  __uint128_t r = (__uint128_t)*a * *b;
+  *a = (uint64_t)r;
+  *b = (uint64_t)(r >> 64);
+}
+
+static inline uint64_t wy_mix(uint64_t a, uint64_t b) {
+  wy_mum(&a, &b);
+  return a ^ b;
+}
+
+static inline uint64_t wy_read8(const uint8_t *p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline uint64_t wy_read4(const uint8_t *p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline uint64_t wy_read3(const uint8_t *p, size_t len) {
+  return ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+}
+
+// wyhash (final version), reading whole words so short identifiers hash in a handful of multiplies
+static uint64_t wyhash(const void *key, size_t len) {
+  const uint8_t *p = (const uint8_t *)key;
+  uint64_t seed = wy_mix(wy_secret[0], wy_secret[1]);
+  uint64_t a, b;
+  if (len <= 16) {
+    if (len >= 4) {
+      size_t shift = (len >> 3) << 2;
+      a = (wy_read4(p) << 32) | wy_read4(p + shift);
+      b = (wy_read4(p + len - 4) << 32) | wy_read4(p + len - 4 - shift);
+    } else if (len > 0) {
+      a = wy_read3(p, len);
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    size_t i = len;
+    if (i > 48) {
+      uint64_t see1 = seed, see2 = seed;
+      do {
+        seed = wy_mix(wy_read8(p) ^ wy_secret[1], wy_read8(p + 8) ^ seed);
+        see1 = wy_mix(wy_read8(p + 16) ^ wy_secret[2], wy_read8(p + 24) ^ see1);
+        see2 = wy_mix(wy_read8(p + 32) ^ wy_secret[3], wy_read8(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = wy_mix(wy_read8(p) ^ wy_secret[1], wy_read8(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = wy_read8(p + i - 16);
+    b = wy_read8(p + i - 8);
+  }
+  a ^= wy_secret[1];
+  b ^= seed;
+  wy_mum(&a, &b);
+  return wy_mix(a ^ wy_secret[0] ^ len, b ^ wy_secret[1]);
+}
+
+static slot *alloc_slots(size_t count) {
+  slot *slots = (slot *)malloc(count * sizeof(slot));
+  if (slots == NULL) return NULL;
+  for (size_t i = 0; i < count; i++) slots[i].id = STRINTERN_INVALID;
+  return slots;
+}
+
+strintern_t *strintern_create(c_arena_t *arena) {
+  if (arena == NULL) return NULL;
+
+  strintern_t *interner = (strintern_t *)malloc(sizeof(strintern_t));
+  if (interner == NULL) return NULL;
+  interner->slots = alloc_slots(STRINTERN_INITIAL_SLOTS);
+  if (interner->slots == NULL) {
+    free(interner);
+    return NULL;
+  }
+  interner->arena = arena;
+  interner->entries = NULL;
+  interner->count = 0;
+  interner->entry_cap = 0;
+  interner->mask = STRINTERN_INITIAL_SLOTS - 1;
+
+  return interner;
+}
+
+void strintern_free(strintern_t *interner) {
+  free(interner->slots);
+  free(interner->entries);
+  free(interner);
+}
+
+// Finds the slot holding `str`, or the empty slot it would go in
+static slot *find_slot(const strintern_t *interner, const char *str, size_t len, uint32_t hash) {
+  for (size_t i = hash & interner->mask;; i = (i + 1) & interner->mask) {
+    slot *s = &interner->slots[i];
+    if (s->id == STRINTERN_INVALID) return s;
+    if (s->hash != hash) continue;
+    const c_str_t *e = &interner->entries[s->id];
+    if (e->len == len && memcmp(e->ptr, str, len) == 0) return s;
+  }
+}
+
+// Doubles the table, keeping it at most half full so probe sequences stay short
+static bool grow_slots(strintern_t *interner) {
+  size_t count = (interner->mask + 1) * 2;
+  slot *slots = alloc_slots(count);
+  if (slots == NULL) return false;
+
+  for (size_t i = 0; i <= interner->mask; i++) {
+    slot s = interner->slots[i];
+    if (s.id == STRINTERN_INVALID) continue;
+    size_t j = s.hash & (count - 1);
+    while (slots[j].id != STRINTERN_INVALID) j = (j + 1) & (count - 1);
+    slots[j] = s;
+  }
+  free(interner->slots);
+  interner->slots = slots;
+  interner->mask = count - 1;
+
+  return true;
+}
+
+static bool reserve_entry(strintern_t *interner) {
+  if (interner->count < interner->entry_cap) return true;
+  size_t cap = interner->entry_cap == 0 ? STRINTERN_INITIAL_SLOTS / 2 : interner->entry_cap * 2;
+  c_str_t *entries = (c_str_t *)realloc(interner->entries, cap * sizeof(c_str_t));
+  if (entries == NULL) return false;
+  interner->entries = entries;
+  interner->entry_cap = cap;
+  return true;
+}
+
+uint32_t strintern_intern(strintern_t *interner, const char *str, size_t len) {
+  uint32_t hash = (uint32_t)wyhash(str, len);
+  slot *s = find_slot(interner, str, len, hash);
+  if (s->id != STRINTERN_INVALID) return s->id;
+
+  // Ids must stay clear of the empty marker
+  if (interner->count >= STRINTERN_INVALID) return STRINTERN_INVALID;
+  if (!reserve_entry(interner)) return STRINTERN_INVALID;
+  if ((interner->count + 1) * 2 > interner->mask + 1) {
+    if (!grow_slots(interner)) return STRINTERN_INVALID;
+    s = find_slot(interner, str, len, hash);
+  }
+
+  char *copy = (char *)arena_alloc_aligned(interner->arena, len + 1, 1);
+  if (copy == NULL) return STRINTERN_INVALID;
+  memcpy(copy, str, len);
+  copy[len] = '\0';
+
+  uint32_t id = (uint32_t)interner->count++;
+  interner->entries[id] = (c_str_t){ .ptr = copy, .len = len };
+  s->hash = hash;
+  s->id = id;
+
+  return id;
+}
+
+uint32_t strintern_lookup(const strintern_t *interner, const char *str, size_t len) {
+  return find_slot(interner, str, len, (uint32_t)wyhash(str, len))->id;
+}
+
+c_str_t strintern_get(const strintern_t *interner, uint32_t id) {
+  if (id >= interner->count) return (c_str_t){ .ptr = NULL, .len = 0 };
+  return interner->entries[id];
+}
+
+size_t strintern_count(const strintern_t *interner) {
+  return interner->count;
+}
@@ -8,37 +8,71 @@
 typedef c_vector_t vector_t;
 
 struct vector_t {
-  void *mem; // 8
-  size_t size; // 8
-  size_t capacity; // 8
-  size_t elem_size; // 8
+  struct vector_head head; // 32 - Must be first, read by the inline push_back fast path
+  c_allocator_t allocator; // 32
+  c_growth_policy_t growth; // 32
 };
 
 static const size_t VECTOR_BEGINNING_CAP = 3;
 
 vector_t *vector_create(size_t elem_size) {
+  return vector_create_with_allocator(elem_size, NULL);
+}
+
+vector_t *vector_create_with_allocator(size_t elem_size, const c_allocator_t *allocator) {
   if (elem_size == 0) return NULL;
 
-  vector_t *vec = (vector_t*)malloc(sizeof(vector_t));
+  c_allocator_t alloc = allocator != NULL ? *allocator : allocator_default();
+
+  vector_t *vec = (vector_t*)alloc.alloc(alloc.ctx, sizeof(vector_t));
   if (vec == NULL) return NULL;
   // Start with size for 3 elements (over-allocation for ammortised cost)
-  vec->mem = malloc(elem_size * VECTOR_BEGINNING_CAP);
-  if (vec->mem == NULL) {
-    free(vec);
+  vec->head.mem = alloc.alloc(alloc.ctx, elem_size * VECTOR_BEGINNING_CAP);
+  if (vec->head.mem == NULL) {
+    alloc.free(alloc.ctx, vec, sizeof(vector_t));
     return NULL;
   }
 
-  vec->capacity = VECTOR_BEGINNING_CAP;
-  vec->size = 0;
-  vec->elem_size = elem_size;
+  vec->head.capacity = VECTOR_BEGINNING_CAP;
+  vec->head.size = 0;
+  vec->head.elem_size = elem_size;
+  vec->allocator = alloc;
+  vec->growth = GROWTH_POLICY_DEFAULT;
 
   return vec;
 }
 
 void vector_free(vector_t *vector) {
   if (vector == NULL) return;
-  free(vector->mem);
-  free(vector);
+  c_allocator_t alloc = vector->allocator;
+  alloc.free(alloc.ctx, vector->head.mem, vector->head.capacity * vector->head.elem_size);
+  alloc.free(alloc.ctx, vector, sizeof(vector_t));
+}
+
+// Moves the vector's elements into memory for `capacity` elements
+static int vector_realloc(vector_t *vector, size_t capacity) {
+  if (capacity > SIZE_MAX / vector->head.elem_size) return -1;
+  void *new_mem = vector->allocator.realloc(vector->allocator.ctx, vector->head.mem,
+                                            vector->head.capacity * vector->head.elem_size, capacity * vector->head.elem_size);
+  if (new_mem == NULL) return -1;
+  vector->head.mem = new_mem;
+  vector->head.capacity = capacity;
+  return 0;
+}
+
+// Grows the vector to fit at least `required` elements, following its growth policy
+static int vector_grow(vector_t *vector, size_t required) {
+  size_t builtin = vector_grow_capacity(vector->head.capacity);
+  return vector_realloc(vector, growth_policy_next(&vector->growth, vector->head.capacity, required, builtin));
+}
+
+// Makes room for `extra` more elements with a single reallocation, keeping growth amortised
+static int vector_ensure_extra(vector_t *vector, size_t extra) {
+  if (extra > SIZE_MAX / vector->head.elem_size - vector->head.size) return -1;
+  size_t required = vector->head.size + extra;
+  if (required <= vector->head.capacity) return 0;
+
+  return vector_grow(vector, required);
 }
 
 int vector_set(vector_t *vector, size_t index, const void *value) {
@@ -46,11 +80,11 @@ int vector_set(vector_t *vector, size_t index, const void *value) {
   if (value == NULL) return -1;
 
   // size_t cannot be negative
-  if (index >= vector->size) return -1;
+  if (index >= vector->head.size) return -1;
 
-  char *memptr = (char*)vector->mem;
+  char *memptr = (char*)vector->head.mem;
   // Copy it in
-  memcpy(&memptr[index * vector->elem_size], value, vector->elem_size);
+  memcpy(&memptr[index * vector->head.elem_size], value, vector->head.elem_size);
 
   return 0;
 }
@@ -59,118 +93,243 @@ int vector_get(const vector_t *vector, size_t index, void *out) {
   if (vector == NULL) return -1;
   if (out == NULL) return -1;
 
-  if (index >= vector->size) return -1;
+  if (index >= vector->head.size) return -1;
 
-  char *memptr = (char*)vector->mem;
-  memcpy(out, &memptr[index * vector->elem_size], vector->elem_size);
+  char *memptr = (char*)vector->head.mem;
+  memcpy(out, &memptr[index * vector->head.elem_size], vector->head.elem_size);
 
   return 0;
 }
 
+void *vector_at(const vector_t *vector, size_t index) {
+  if (vector == NULL) return NULL;
+  if (index >= vector->head.size) return NULL;
+
+  return (char*)vector->head.mem + index * vector->head.elem_size;
+}
+
+void *vector_back(const vector_t *vector) {
+  if (vector == NULL) return NULL;
+  if (vector->head.size == 0) return NULL;
+
+  return (char*)vector->head.mem + (vector->head.size - 1) * vector->head.elem_size;
+}
+
+void *vector_data(const vector_t *vector) {
+  if (vector == NULL) return NULL;
+  return vector->head.mem;
+}
+
 int vector_insert(vector_t *vector, size_t index, const void *value) {
   if (vector == NULL) return -1;
   if (value == NULL) return -1;
 
   // size_t cannot be negative
-  if (vector->size < index) return -1;
+  if (vector->head.size < index) return -1;
 
-  if (vector->capacity == vector->size) {
+  if (vector->head.capacity == vector->head.size) {
     // Need to resize
-    size_t grow_to = VECTOR_GROW(vector->capacity);
-    void *new_mem = realloc(vector->mem, grow_to * vector->elem_size);
-    if (new_mem == NULL) return -1;
-    vector->mem = new_mem;
-    vector->capacity = grow_to;
+    if (vector_grow(vector, vector->head.size + 1) == -1) return -1;
   }
 
-  char *memptr = (char*)vector->mem;
+  char *memptr = (char*)vector->head.mem;
 
   // Move memory forward to make room
-  memmove(&memptr[vector->elem_size * (index + 1)], &memptr[vector->elem_size * index], vector->elem_size * (vector->size - index));
+  memmove(&memptr[vector->head.elem_size * (index + 1)], &memptr[vector->head.elem_size * index], vector->head.elem_size * (vector->head.size - index));
 
   // Copy the value of the item in
-  memcpy(&memptr[index * vector->elem_size], value, vector->elem_size);
-  vector->size++;
+  memcpy(&memptr[index * vector->head.elem_size], value, vector->head.elem_size);
+  vector->head.size++;
+
+  return 0;
+}
+
+int vector_insert_range(vector_t *vector, size_t index, const void *values, size_t count) {
+  if (vector == NULL) return -1;
+  if (values == NULL && count > 0) return -1;
+  if (vector->head.size < index) return -1;
+  if (count == 0) return 0;
+
+  // The values may come from the vector itself, which growing could free
+  size_t elem_size = vector->head.elem_size;
+  uintptr_t start = (uintptr_t)vector->head.mem;
+  bool aliased = (uintptr_t)values >= start && (uintptr_t)values < start + vector->head.size * elem_size;
+  size_t source = (uintptr_t)values - start;
+
+  if (vector_ensure_extra(vector, count) == -1) return -1;
+
+  char *memptr = (char*)vector->head.mem;
+  size_t target = index * elem_size;
+  size_t length = count * elem_size;
+
+  // Move the tail forward once to make room for the whole range
+  memmove(&memptr[target + length], &memptr[target], (vector->head.size - index) * elem_size);
+  if (!aliased) {
+    memcpy(&memptr[target], values, length);
+  } else if (source >= target) {
+    // The source was entirely in the tail, which just moved
+    memcpy(&memptr[target], &memptr[source + length], length);
+  } else {
+    // The part before the insertion point stayed put, the rest moved with the tail
+    size_t before = target - source < length ? target - source : length;
+    memcpy(&memptr[target], &memptr[source], before);
+    memcpy(&memptr[target + before], &memptr[target + length], length - before);
+  }
+  vector->head.size += count;
+
+  return 0;
+}
+
+int vector_append_n(vector_t *vector, const void *values, size_t count) {
+  if (vector == NULL) return -1;
+  return vector_insert_range(vector, vector->head.size, values, count);
+}
+
+int vector_erase_range(vector_t *vector, size_t index, size_t count) {
+  if (vector == NULL) return -1;
+  if (index > vector->head.size || count > vector->head.size - index) return -1;
+
+  char *memptr = (char*)vector->head.mem;
+
+  // Close the gap with a single move of the tail
+  memmove(&memptr[index * vector->head.elem_size], &memptr[(index + count) * vector->head.elem_size], (vector->head.size - index - count) * vector->head.elem_size);
+  vector->head.size -= count;
+
+  return 0;
+}
+
+int vector_assign(vector_t *vector, const void *values, size_t count) {
+  if (vector == NULL) return -1;
+  if (values == NULL && count > 0) return -1;
+
+  // Nothing needs preserving, so grow straight to the exact size
+  if (count > vector->head.capacity) {
+    if (count > SIZE_MAX / vector->head.elem_size) return -1;
+    if (vector_realloc(vector, count) == -1) return -1;
+  }
+  // The values may be a later part of the vector itself
+  if (count > 0) memmove(vector->head.mem, values, count * vector->head.elem_size);
+  vector->head.size = count;
 
   return 0;
 }
 
 int vector_remove(vector_t *vector, size_t index, void *out) {
   if (vector == NULL) return -1;
-  if (vector->size == 0) return -1;
-  if (index >= vector->size) return -1;
+  if (vector->head.size == 0) return -1;
+  if (index >= vector->head.size) return -1;
 
-  char *memptr = (char*)vector->mem;
+  char *memptr = (char*)vector->head.mem;
   if (out != NULL) {
-    memcpy(out, &memptr[index * vector->elem_size], vector->elem_size);
+    memcpy(out, &memptr[index * vector->head.elem_size], vector->head.elem_size);
   }
 
   // Move things back to fill the empty space
-  memmove(&memptr[index * vector->elem_size], &memptr[(index + 1) * vector->elem_size], (vector->size - index - 1) * vector->elem_size);
+  memmove(&memptr[index * vector->head.elem_size], &memptr[(index + 1) * vector->head.elem_size], (vector->head.size - index - 1) * vector->head.elem_size);
 
-  vector->size--;
+  vector->head.size--;
 
   return 0;
 }
 
-int vector_push_back(vector_t *vector, const void *value) {
-  return vector_insert(vector, vector->size, value);
+// Emitted here so the inline fast path has a single out-of-line definition in the library
+extern inline int vector_push_back(vector_t *vector, const void *value);
+
+int vector_push_back_slow(vector_t *vector, const void *value) {
+  if (vector == NULL) return -1;
+  if (value == NULL) return -1;
+
+  if (vector->head.capacity == vector->head.size) {
+    if (vector_grow(vector, vector->head.size + 1) == -1) return -1;
+  }
+
+  memcpy((char*)vector->head.mem + vector->head.size * vector->head.elem_size, value, vector->head.elem_size);
+  vector->head.size++;
+
+  return 0;
+}
+
+void *vector_emplace_back(vector_t *vector) {
+  if (vector == NULL) return NULL;
+
+  if (vector->head.capacity == vector->head.size) {
+    if (vector_grow(vector, vector->head.size + 1) == -1) return NULL;
+  }
+
+  return (char*)vector->head.mem + vector->head.size++ * vector->head.elem_size;
 }
 
 int vector_pop_back(vector_t *vector, void *out) {
-  return vector_remove(vector, vector->size - 1, out);
+  return vector_remove(vector, vector->head.size - 1, out);
 }
 
 int vector_reserve(vector_t *vector, size_t capacity) {
   if (vector == NULL) return -1;
-  if (capacity < vector->capacity) return -1;
-  if (capacity == vector->capacity) return 0;
-
-  void *new_mem = realloc(vector->mem, capacity * vector->elem_size);
-  if (new_mem == NULL) return -1;
-  vector->mem = new_mem;
-  vector->capacity = capacity;
+  if (capacity < vector->head.capacity) return -1;
+  if (capacity == vector->head.capacity) return 0;
 
-  return 0;
+  return vector_realloc(vector, capacity);
 }
 
 int vector_resize(vector_t *vector, size_t size, const void *default_value) {
   if (vector == NULL) return -1;
-  if (size == vector->size) return 0;
+  if (size == vector->head.size) return 0;
 
   // Ensure we have enough capacity
-  if (size > vector->capacity) {
+  if (size > vector->head.capacity) {
     // Reserve enough space + over-allocation
-    if (vector_reserve(vector, VECTOR_GROW(size)) == -1) return -1;
+    size_t capacity = growth_policy_next(&vector->growth, vector->head.capacity, size, vector_grow_capacity(size));
+    if (vector_reserve(vector, capacity) == -1) return -1;
   }
 
   // If we're expanding
-  if (size > vector->size) {
+  if (size > vector->head.size) {
     if (default_value == NULL) return -1;
     // Initialise everything to the default value
-    char *memptr = (char*)vector->mem;
-    for (size_t i = vector->size; i < size; i++) {
-      memcpy(&memptr[i * vector->elem_size], default_value, vector->elem_size);
+    char *memptr = (char*)vector->head.mem;
+    for (size_t i = vector->head.size; i < size; i++) {
+      memcpy(&memptr[i * vector->head.elem_size], default_value, vector->head.elem_size);
     }
   }
   // Don't need to do anything for shrinking, simply changing the size
   // value makes further ones inaccessible via `get`
-  vector->size = size;
+  vector->head.size = size;
 
   return 0;
 }
 
 size_t vector_size(const vector_t *vector) {
   if (vector == NULL) return 0;
-  return vector->size;
+  return vector->head.size;
 }
 
 size_t vector_capacity(const vector_t *vector) {
   if (vector == NULL) return 0;
-  return vector->capacity;
+  return vector->head.capacity;
+}
+
+int vector_shrink_to_fit(vector_t *vector) {
+  if (vector == NULL) return -1;
+
+  // Keeps room for one element, so the memory is never released outright
+  size_t capacity = vector->head.size > 0 ? vector->head.size : 1;
+  if (capacity >= vector->head.capacity) return 0;
+
+  return vector_realloc(vector, capacity);
+}
+
+int vector_set_growth(vector_t *vector, c_growth_policy_t policy) {
+  if (vector == NULL) return -1;
+  if (!growth_policy_valid(&policy)) return -1;
+  vector->growth = policy;
+  return 0;
+}
+
+size_t vector_grow_capacity(size_t capacity) {
+  return VECTOR_GROW(capacity);
 }
 
 bool vector_empty(const vector_t *vector) {
   if (vector == NULL) return false;
-  return vector->size == 0;
+  return vector->head.size == 0;
 }
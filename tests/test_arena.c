@@ -47,6 +47,7 @@ void test_arena_alloc() {
 void test_arena_reset() {
   c_arena_t *arena = arena_create_flags(182, ARENA_NO_FLAGS);
   TEST_ASSERT_NOT_NULL(arena);
+  arena_set_reset_policy(arena, ARENA_RESET_ZERO_USED);
   char *msg = arena_alloc(arena, 12);
   strncpy(msg, "hello world", 12);
   TEST_ASSERT_TRUE(strcmp(msg, "hello world") == 0);
@@ -57,6 +58,168 @@ void test_arena_reset() {
   arena_free(arena);
 }
 
+void test_arena_reset_zero_after_rewind() {
+  c_arena_t *arena = arena_create_flags(64, ARENA_GROWABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  arena_set_reset_policy(arena, ARENA_RESET_ZERO_USED);
+  c_arena_mark_t mark = arena_mark(arena);
+  char *first = arena_alloc(arena, 48);
+  memset(first, 0xAB, 48);
+  // Doesn't fit the head, so crosses into a grown node
+  char *second = arena_alloc(arena, 100);
+  memset(second, 0xCD, 100);
+  arena_rewind(arena, mark);
+  // The rewound bytes were still written this cycle
+  arena_reset(arena);
+  TEST_ASSERT_TRUE(arena_alloc(arena, 48) == first);
+  TEST_ASSERT_TRUE(arena_alloc(arena, 100) == second);
+  for (int i = 0; i < 48; i++) TEST_ASSERT_EQUAL_HEX8(0, first[i]);
+  for (int i = 0; i < 100; i++) TEST_ASSERT_EQUAL_HEX8(0, second[i]);
+  arena_free(arena);
+}
+
+void test_arena_reset_keep() {
+  c_arena_t *arena = arena_create_flags(182, ARENA_NO_FLAGS);
+  TEST_ASSERT_NOT_NULL(arena);
+  char *msg = arena_alloc(arena, 12);
+  strncpy(msg, "hello world", 12);
+  // Default policy must not touch the memory
+  arena_reset(arena);
+  TEST_ASSERT_TRUE(strcmp(msg, "hello world") == 0);
+  TEST_ASSERT_TRUE(arena_alloc(arena, 12) == msg);
+  arena_free(arena);
+}
+
+void test_arena_reset_release() {
+  c_arena_t *arena = arena_create_flags(1024 * 1024, ARENA_NO_FLAGS);
+  TEST_ASSERT_NOT_NULL(arena);
+  arena_set_reset_policy(arena, ARENA_RESET_RELEASE);
+  char *block = arena_alloc(arena, 512 * 1024);
+  TEST_ASSERT_NOT_NULL(block);
+  memset(block, 0xAB, 512 * 1024);
+  arena_reset(arena);
+  char *again = arena_alloc(arena, 512 * 1024);
+  TEST_ASSERT_TRUE(again == block);
+  memset(again, 0xCD, 512 * 1024);
+  TEST_ASSERT_TRUE((unsigned char)again[256 * 1024] == 0xCD);
+  arena_free(arena);
+}
+
+void test_arena_reset_retain() {
+  c_arena_t *arena = arena_create_flags(64, ARENA_GROWABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  for (int i = 0; i < 64; i++) arena_alloc_aligned(arena, 60, 1);
+  TEST_ASSERT_TRUE(arena_stats(arena).node_count > 2);
+  arena_reset_retain(arena, 1024);
+  // Coalesced into one node of the retained size
+  c_arena_stats_t stats = arena_stats(arena);
+  TEST_ASSERT_TRUE(stats.node_count == 1);
+  TEST_ASSERT_TRUE(stats.reserved == 1024);
+  char *first = arena_alloc_aligned(arena, 1000, 1);
+  TEST_ASSERT_NOT_NULL(first);
+  memset(first, 0xAB, 1000);
+  TEST_ASSERT_TRUE(arena_stats(arena).node_count == 1);
+  // Shrinks back down, but never below the initial size
+  arena_reset_retain(arena, 0);
+  TEST_ASSERT_TRUE(arena_stats(arena).reserved == 64);
+  TEST_ASSERT_NOT_NULL(arena_alloc_aligned(arena, 64, 1));
+  arena_free(arena);
+}
+
+void test_arena_reset_retain_decayed() {
+  c_arena_t *arena = arena_create_flags(64, ARENA_GROWABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  // One spike, then many small cycles
+  for (int i = 0; i < 256; i++) arena_alloc_aligned(arena, 60, 1);
+  arena_reset_retain(arena, ARENA_RETAIN_DECAYED);
+  size_t after_spike = arena_stats(arena).reserved;
+  TEST_ASSERT_TRUE(after_spike >= 256 * 60);
+  for (int cycle = 0; cycle < 32; cycle++) {
+    arena_alloc_aligned(arena, 32, 1);
+    arena_reset_retain(arena, ARENA_RETAIN_DECAYED);
+  }
+  TEST_ASSERT_TRUE(arena_stats(arena).reserved < after_spike);
+  TEST_ASSERT_TRUE(arena_stats(arena).high_water >= 256 * 60);
+  arena_free(arena);
+}
+
+void test_arena_reset_retain_virtual() {
+  c_arena_t *arena = arena_create_flags(16 * 1024 * 1024, ARENA_VIRTUAL);
+  TEST_ASSERT_NOT_NULL(arena);
+  arena_set_reset_policy(arena, ARENA_RESET_KEEP);
+  char *block = arena_alloc_aligned(arena, 4 * 1024 * 1024, 1);
+  memset(block, 0xAB, 4 * 1024 * 1024);
+  arena_reset_retain(arena, 1024 * 1024);
+  TEST_ASSERT_TRUE(arena_stats(arena).committed <= 1024 * 1024);
+  TEST_ASSERT_TRUE(arena_alloc_aligned(arena, 2 * 1024 * 1024, 1) == block);
+  arena_free(arena);
+}
+
+void test_arena_realloc_in_place() {
+  c_arena_t *arena = arena_create_flags(1024, ARENA_NO_FLAGS);
+  TEST_ASSERT_NOT_NULL(arena);
+  char *str = arena_realloc(arena, NULL, 0, 6);
+  TEST_ASSERT_NOT_NULL(str);
+  strcpy(str, "hello");
+  char *grown = arena_realloc(arena, str, 6, 12);
+  TEST_ASSERT_TRUE(grown == str);
+  strcat(grown, " world");
+  char *shrunk = arena_realloc(arena, grown, 12, 12);
+  TEST_ASSERT_TRUE(shrunk == str);
+  TEST_ASSERT_TRUE(strcmp(shrunk, "hello world") == 0);
+  shrunk = arena_realloc(arena, grown, 12, 6);
+  TEST_ASSERT_TRUE(shrunk == str);
+  // Shrinking handed the tail back
+  TEST_ASSERT_TRUE(arena_alloc_aligned(arena, 1, 1) == str + 6);
+  arena_free(arena);
+}
+
+void test_arena_realloc_shrink_zeroed() {
+  c_arena_t *arena = arena_create_flags(1024, ARENA_NO_FLAGS);
+  TEST_ASSERT_NOT_NULL(arena);
+  arena_set_reset_policy(arena, ARENA_RESET_ZERO_USED);
+  char *buf = arena_alloc(arena, 100);
+  memset(buf, 0xEE, 100);
+  TEST_ASSERT_TRUE(arena_realloc(arena, buf, 100, 10) == buf);
+  // The handed back tail was still written this cycle
+  arena_reset(arena);
+  for (int i = 0; i < 100; i++) TEST_ASSERT_EQUAL_HEX8(0, buf[i]);
+  arena_free(arena);
+}
+
+void test_arena_realloc_moves() {
+  c_arena_t *arena = arena_create_flags(64, ARENA_GROWABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  char *str = arena_alloc(arena, 12);
+  strcpy(str, "hello world");
+  // No longer the most recent allocation
+  TEST_ASSERT_NOT_NULL(arena_alloc(arena, 1));
+  char *moved = arena_realloc(arena, str, 12, 24);
+  TEST_ASSERT_TRUE(moved != str);
+  TEST_ASSERT_TRUE(strcmp(moved, "hello world") == 0);
+  // Shrinking never needs to move
+  TEST_ASSERT_NOT_NULL(arena_alloc(arena, 1));
+  TEST_ASSERT_TRUE(arena_realloc(arena, moved, 24, 12) == moved);
+  // Doesn't fit the rest of the node, so moves to the next
+  char *big = arena_realloc(arena, moved, 12, 100);
+  TEST_ASSERT_NOT_NULL(big);
+  TEST_ASSERT_TRUE(strcmp(big, "hello world") == 0);
+  arena_free(arena);
+}
+
+void test_arena_realloc_virtual() {
+  c_arena_t *arena = arena_create_flags(64 * 1024 * 1024, ARENA_VIRTUAL);
+  TEST_ASSERT_NOT_NULL(arena);
+  char *buf = arena_alloc(arena, 16);
+  for (size_t size = 16; size < 8 * 1024 * 1024; size *= 2) {
+    char *grown = arena_realloc(arena, buf, size, size * 2);
+    // Always in place, committing pages as it goes
+    TEST_ASSERT_TRUE(grown == buf);
+    memset(buf + size, 0xAB, size);
+  }
+  arena_free(arena);
+}
+
 void test_fail_when_full() {
   c_arena_t *arena = arena_create_flags(sizeof(int) * 4, ARENA_NO_FLAGS);
   TEST_ASSERT_NOT_NULL(arena);
@@ -88,6 +251,525 @@ void test_arena_grow() {
   arena_free(arena);
 }
 
+void test_arena_virtual() {
+  c_arena_t *arena = arena_create_flags(64 * 1024 * 1024, ARENA_VIRTUAL);
+  TEST_ASSERT_NOT_NULL(arena);
+  // Spans many commit steps without ever leaving the reservation
+  char *first = arena_alloc_aligned(arena, 1, 1);
+  TEST_ASSERT_NOT_NULL(first);
+  char *prev = first;
+  for (int i = 0; i < 100; i++) {
+    char *block = arena_alloc_aligned(arena, 100 * 1024, 1);
+    TEST_ASSERT_NOT_NULL(block);
+    TEST_ASSERT_TRUE(block == prev + (i == 0 ? 1 : 100 * 1024));
+    memset(block, 0xAB, 100 * 1024);
+    prev = block;
+  }
+  arena_reset(arena);
+  char *again = arena_alloc_aligned(arena, 16, 1);
+  TEST_ASSERT_TRUE(again == first);
+  TEST_ASSERT_TRUE(again[0] == 0);
+  arena_free(arena);
+}
+
+void test_arena_virtual_exhausted() {
+  c_arena_t *arena = arena_create_flags(4096, ARENA_VIRTUAL | ARENA_GROWABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  TEST_ASSERT_NOT_NULL(arena_alloc(arena, 4000));
+  TEST_ASSERT_NULL(arena_alloc(arena, 4096));
+  arena_free(arena);
+}
+
+void test_arena_huge_pages() {
+  c_arena_t *arena = arena_create_flags(4096, ARENA_HUGE_PAGES | ARENA_GROWABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  // Nodes are rounded up to whole huge pages and aligned to them
+  char *first = arena_alloc_aligned(arena, 1, 1);
+  TEST_ASSERT_NOT_NULL(first);
+  TEST_ASSERT_EQUAL_UINT64(0, (uintptr_t)first % (2 * 1024 * 1024));
+  TEST_ASSERT_EQUAL_UINT64(2 * 1024 * 1024, arena_stats(arena).reserved);
+  char *block = arena_alloc(arena, 3 * 1024 * 1024);
+  TEST_ASSERT_NOT_NULL(block);
+  memset(block, 0xAB, 3 * 1024 * 1024);
+  arena_reset(arena);
+  TEST_ASSERT_TRUE(arena_alloc_aligned(arena, 1, 1) == first);
+  arena_free(arena);
+
+  // Growth that doesn't land on whole huge pages still accounts the rounded nodes
+  arena = arena_create_flags(4096, ARENA_HUGE_PAGES | ARENA_GROWABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  TEST_ASSERT_TRUE(arena_set_growth(arena, (c_arena_growth_t){ .factor = 1.5, .large_threshold = 64 * 1024 * 1024 }) == 0);
+  for (int i = 0; i < 12; i++) TEST_ASSERT_NOT_NULL(arena_alloc(arena, 1024 * 1024));
+  c_arena_stats_t stats = arena_stats(arena);
+  TEST_ASSERT_TRUE(stats.node_count > 2);
+  TEST_ASSERT_EQUAL_UINT64(stats.committed, stats.reserved);
+  arena_free(arena);
+}
+
+void test_arena_hugetlb_falls_back() {
+  // Succeeds whether or not the kernel has huge pages reserved
+  c_arena_t *arena = arena_create_flags(4096, ARENA_HUGETLB);
+  TEST_ASSERT_NOT_NULL(arena);
+  char *block = arena_alloc(arena, 1024 * 1024);
+  TEST_ASSERT_NOT_NULL(block);
+  memset(block, 0xCD, 1024 * 1024);
+  arena_free(arena);
+}
+
+void test_arena_huge_pages_virtual() {
+  c_arena_t *arena = arena_create_flags(64 * 1024 * 1024, ARENA_VIRTUAL | ARENA_HUGE_PAGES);
+  TEST_ASSERT_NOT_NULL(arena);
+  char *block = arena_alloc(arena, 100);
+  TEST_ASSERT_NOT_NULL(block);
+  TEST_ASSERT_EQUAL_UINT64(0, (uintptr_t)block % (2 * 1024 * 1024));
+  // Pages are committed a whole huge page at a time
+  TEST_ASSERT_EQUAL_UINT64(2 * 1024 * 1024, arena_stats(arena).committed);
+  arena_free(arena);
+}
+
+static char defer_log[16];
+static int defer_count = 0;
+
+static void record_defer(void *ctx) {
+  defer_log[defer_count++] = *(char *)ctx;
+}
+
+void test_arena_defer_reset() {
+  c_arena_t *arena = arena_create_flags(1024, ARENA_NO_FLAGS);
+  TEST_ASSERT_NOT_NULL(arena);
+  defer_count = 0;
+  char *names = arena_alloc(arena, 3);
+  memcpy(names, "abc", 3);
+  for (int i = 0; i < 3; i++) TEST_ASSERT_EQUAL_INT(0, arena_defer(arena, record_defer, &names[i]));
+  TEST_ASSERT_EQUAL_INT(0, defer_count);
+  // Run newest first, while the arena's memory is still intact
+  arena_reset(arena);
+  TEST_ASSERT_EQUAL_INT(3, defer_count);
+  TEST_ASSERT_EQUAL_MEMORY("cba", defer_log, 3);
+  // And only once
+  arena_reset(arena);
+  TEST_ASSERT_EQUAL_INT(3, defer_count);
+  arena_free(arena);
+  TEST_ASSERT_EQUAL_INT(3, defer_count);
+}
+
+void test_arena_defer_free() {
+  c_arena_t *arena = arena_create_flags(16, ARENA_GROWABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  defer_count = 0;
+  static char names[] = "0123456789";
+  // Spans several memory nodes
+  for (int i = 0; i < 10; i++) TEST_ASSERT_EQUAL_INT(0, arena_defer(arena, record_defer, &names[i]));
+  arena_free(arena);
+  TEST_ASSERT_EQUAL_INT(10, defer_count);
+  TEST_ASSERT_EQUAL_MEMORY("9876543210", defer_log, 10);
+}
+
+void test_arena_defer_rewind() {
+  c_arena_t *arena = arena_create_flags(1024, ARENA_NO_FLAGS);
+  TEST_ASSERT_NOT_NULL(arena);
+  defer_count = 0;
+  static char names[] = "abc";
+  arena_defer(arena, record_defer, &names[0]);
+  c_arena_mark_t mark = arena_mark(arena);
+  arena_defer(arena, record_defer, &names[1]);
+  arena_defer(arena, record_defer, &names[2]);
+  // Only callbacks deferred since the mark run
+  arena_rewind(arena, mark);
+  TEST_ASSERT_EQUAL_INT(2, defer_count);
+  TEST_ASSERT_EQUAL_MEMORY("cb", defer_log, 2);
+  arena_free(arena);
+  TEST_ASSERT_EQUAL_INT(3, defer_count);
+  TEST_ASSERT_EQUAL_INT('a', defer_log[2]);
+}
+
+void test_arena_alloc_array() {
+  c_arena_t *arena = arena_create_flags(1024, ARENA_NO_FLAGS);
+  TEST_ASSERT_NOT_NULL(arena);
+  int *nums = arena_alloc_array(arena, 16, sizeof(int), alignof(int));
+  TEST_ASSERT_NOT_NULL(nums);
+  TEST_ASSERT_EQUAL_UINT64(0, (uintptr_t)nums % alignof(int));
+  for (int i = 0; i < 16; i++) nums[i] = i;
+  // Would wrap around to a tiny allocation without the overflow check
+  TEST_ASSERT_NULL(arena_alloc_array(arena, SIZE_MAX / 2 + 2, 2, 1));
+  TEST_ASSERT_EQUAL_UINT64(16 * sizeof(int), arena_stats(arena).used);
+  arena_free(arena);
+}
+
+void test_arena_alloc_many() {
+  c_arena_t *arena = arena_create_flags(1024, ARENA_NO_FLAGS);
+  TEST_ASSERT_NOT_NULL(arena);
+  arena_alloc_aligned(arena, 1, 1);
+  c_arena_block_t blocks[] = {
+    { .size = 24, .align = 8 },
+    { .size = 3, .align = 1 },
+    { .size = 32, .align = 16 },
+  };
+  TEST_ASSERT_EQUAL_INT(0, arena_alloc_many(arena, blocks, 3));
+  char *node = blocks[0].ptr;
+  char *children = blocks[1].ptr;
+  char *payload = blocks[2].ptr;
+  TEST_ASSERT_EQUAL_UINT64(0, (uintptr_t)node % 8);
+  TEST_ASSERT_EQUAL_UINT64(0, (uintptr_t)payload % 16);
+  // Back to back, apart from alignment padding
+  TEST_ASSERT_TRUE(children == node + 24);
+  TEST_ASSERT_TRUE(payload >= children + 3 && payload < children + 3 + 16);
+  // One allocation for the whole batch
+  TEST_ASSERT_EQUAL_UINT64(2, arena_stats(arena).alloc_count);
+
+  c_arena_block_t invalid[] = {
+    { .size = 8, .align = 8 },
+    { .size = 8, .align = 3 },
+  };
+  TEST_ASSERT_EQUAL_INT(-1, arena_alloc_many(arena, invalid, 2));
+  c_arena_block_t too_big[] = {
+    { .size = 512, .align = 8 },
+    { .size = 1024, .align = 8 },
+  };
+  TEST_ASSERT_EQUAL_INT(-1, arena_alloc_many(arena, too_big, 2));
+  // The first block fit the fast path, but isn't handed out
+  TEST_ASSERT_NULL(too_big[0].ptr);
+  TEST_ASSERT_NULL(too_big[1].ptr);
+  TEST_ASSERT_NULL(invalid[0].ptr);
+  TEST_ASSERT_EQUAL_UINT64(2, arena_stats(arena).alloc_count);
+  // An empty batch allocates nothing
+  TEST_ASSERT_EQUAL_INT(0, arena_alloc_many(arena, NULL, 0));
+  TEST_ASSERT_EQUAL_UINT64(2, arena_stats(arena).alloc_count);
+  arena_free(arena);
+}
+
+typedef struct {
+  c_relptr_t next;
+  c_relptr_t name;
+  int value;
+} image_entry;
+
+void test_arena_relptr() {
+  c_arena_t *arena = arena_create_flags(1024, ARENA_NO_FLAGS);
+  TEST_ASSERT_NOT_NULL(arena);
+  image_entry *a = arena_alloc(arena, sizeof(image_entry));
+  image_entry *b = arena_alloc(arena, sizeof(image_entry));
+  relptr_set(&a->next, b);
+  relptr_set(&b->next, NULL);
+  TEST_ASSERT_TRUE(relptr_get(&a->next) == b);
+  TEST_ASSERT_NULL(relptr_get(&b->next));
+  // Moving both keeps the link between them
+  size_t span = (size_t)((char *)b - (char *)a) + sizeof(image_entry);
+  char *moved = arena_alloc(arena, span);
+  memcpy(moved, a, span);
+  TEST_ASSERT_TRUE(relptr_get(&((image_entry *)moved)->next) == moved + ((char *)b - (char *)a));
+  arena_free(arena);
+}
+
+void test_arena_save_load() {
+  const char *path = "test_arena_image.bin";
+  c_arena_t *arena = arena_create_flags(1024 * 1024, ARENA_RELOCATABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  image_entry *head = NULL;
+  for (int i = 0; i < 100; i++) {
+    image_entry *entry = arena_alloc(arena, sizeof(image_entry));
+    char *name = arena_alloc_aligned(arena, 16, 1);
+    snprintf(name, 16, "entry %d", i);
+    entry->value = i;
+    relptr_set(&entry->name, name);
+    relptr_set(&entry->next, head);
+    head = entry;
+  }
+  TEST_ASSERT_EQUAL_INT(0, arena_save(arena, head, path));
+  size_t used = arena_stats(arena).used;
+  arena_free(arena);
+
+  c_arena_image_t *image = arena_load(path);
+  TEST_ASSERT_NOT_NULL(image);
+  TEST_ASSERT_EQUAL_UINT64(used, arena_image_size(image));
+  const image_entry *entry = arena_image_root(image);
+  TEST_ASSERT_EQUAL_UINT64(0, (uintptr_t)entry % alignof(max_align_t));
+  char expected[16];
+  for (int i = 99; i >= 0; i--) {
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL_INT(i, entry->value);
+    snprintf(expected, sizeof(expected), "entry %d", i);
+    TEST_ASSERT_EQUAL_STRING(expected, relptr_get(&entry->name));
+    entry = relptr_get(&entry->next);
+  }
+  TEST_ASSERT_NULL(entry);
+  arena_image_free(image);
+  remove(path);
+}
+
+void test_arena_save_requires_relocatable() {
+  const char *path = "test_arena_image_invalid.bin";
+  c_arena_t *arena = arena_create_flags(1024, ARENA_NO_FLAGS);
+  TEST_ASSERT_NOT_NULL(arena);
+  int *root = arena_alloc(arena, sizeof(int));
+  TEST_ASSERT_EQUAL_INT(-1, arena_save(arena, root, path));
+  arena_free(arena);
+
+  // Roots must come from the arena
+  arena = arena_create_flags(1024, ARENA_RELOCATABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  int outside = 0;
+  TEST_ASSERT_EQUAL_INT(-1, arena_save(arena, &outside, path));
+  arena_free(arena);
+
+  TEST_ASSERT_NULL(arena_load(path));
+}
+
+void test_arena_adaptive() {
+  c_arena_t *arena = arena_create_flags(256, ARENA_GROWABLE | ARENA_ADAPTIVE);
+  TEST_ASSERT_NOT_NULL(arena);
+  // The initial guess is far too small, so the first cycle chains nodes
+  for (int i = 0; i < 40; i++) TEST_ASSERT_NOT_NULL(arena_alloc(arena, 100));
+  TEST_ASSERT_TRUE(arena_stats(arena).node_count > 1);
+  arena_reset(arena);
+  TEST_ASSERT_EQUAL_UINT64(1, arena_stats(arena).node_count);
+
+  // Every later cycle of the same shape fits the coalesced node
+  size_t grows = arena_stats(arena).grow_count;
+  for (int cycle = 0; cycle < 10; cycle++) {
+    for (int i = 0; i < 40; i++) TEST_ASSERT_NOT_NULL(arena_alloc(arena, 100));
+    TEST_ASSERT_EQUAL_UINT64(1, arena_stats(arena).node_count);
+    arena_reset(arena);
+  }
+  TEST_ASSERT_EQUAL_UINT64(grows, arena_stats(arena).grow_count);
+  arena_free(arena);
+
+  // Requests served by dedicated nodes count toward the coalesced node too
+  arena = arena_create_flags(1024, ARENA_GROWABLE | ARENA_ADAPTIVE);
+  TEST_ASSERT_NOT_NULL(arena);
+  for (int i = 0; i < 4; i++) TEST_ASSERT_NOT_NULL(arena_alloc(arena, 100));
+  TEST_ASSERT_NOT_NULL(arena_alloc(arena, 64 * 1024));
+  TEST_ASSERT_EQUAL_UINT64(2, arena_stats(arena).node_count);
+  arena_reset(arena);
+  TEST_ASSERT_EQUAL_UINT64(1, arena_stats(arena).node_count);
+
+  grows = arena_stats(arena).grow_count;
+  for (int cycle = 0; cycle < 10; cycle++) {
+    for (int i = 0; i < 4; i++) TEST_ASSERT_NOT_NULL(arena_alloc(arena, 100));
+    TEST_ASSERT_NOT_NULL(arena_alloc(arena, 64 * 1024));
+    TEST_ASSERT_EQUAL_UINT64(1, arena_stats(arena).node_count);
+    arena_reset(arena);
+  }
+  TEST_ASSERT_EQUAL_UINT64(grows, arena_stats(arena).grow_count);
+  TEST_ASSERT_EQUAL_UINT64(arena_stats(arena).reserved, arena_stats(arena).committed);
+  arena_free(arena);
+}
+
+void test_arena_alloc_invalid_align() {
+  c_arena_t *arena = arena_create_flags(1024, ARENA_NO_FLAGS);
+  TEST_ASSERT_NOT_NULL(arena);
+  TEST_ASSERT_NULL(arena_alloc_aligned(arena, 8, 0));
+  TEST_ASSERT_NULL(arena_alloc_aligned(arena, 8, 12));
+  TEST_ASSERT_NOT_NULL(arena_alloc_aligned(arena, 8, 16));
+  arena_free(arena);
+}
+
+void test_arena_grow_many_nodes() {
+  c_arena_t *arena = arena_create_flags(16, ARENA_GROWABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  int *prev = NULL;
+  for (int i = 0; i < 1000; i++) {
+    int *num = arena_alloc_aligned(arena, sizeof(int), alignof(int));
+    TEST_ASSERT_NOT_NULL(num);
+    *num = i;
+    if (prev != NULL) TEST_ASSERT_TRUE(*prev == i - 1);
+    prev = num;
+  }
+  arena_free(arena);
+}
+
+void test_arena_large_alloc_keeps_node() {
+  c_arena_t *arena = arena_create_flags(256, ARENA_GROWABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  char *small1 = arena_alloc_aligned(arena, 16, 1);
+  // Far larger than the next node, so gets its own
+  char *large = arena_alloc(arena, 64 * 1024);
+  TEST_ASSERT_NOT_NULL(large);
+  memset(large, 0xAB, 64 * 1024);
+  char *small2 = arena_alloc_aligned(arena, 16, 1);
+  TEST_ASSERT_TRUE(small2 == small1 + 16);
+  char *aligned = arena_alloc_aligned(arena, 4096, 4096);
+  TEST_ASSERT_NOT_NULL(aligned);
+  TEST_ASSERT_TRUE((uintptr_t)aligned % 4096 == 0);
+  arena_reset(arena);
+  TEST_ASSERT_TRUE(arena_alloc_aligned(arena, 16, 1) == small1);
+  arena_free(arena);
+}
+
+void test_arena_growth_schedule() {
+  c_arena_t *arena = arena_create_flags(64, ARENA_GROWABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  TEST_ASSERT_TRUE(arena_set_growth(arena, (c_arena_growth_t){ .factor = 0.5 }) == -1);
+  TEST_ASSERT_TRUE(arena_set_growth(arena, (c_arena_growth_t){ .factor = 1.5, .min_node_size = 1024, .max_node_size = 512 }) == -1);
+  c_arena_growth_t growth = { .factor = 1.5, .min_node_size = 1024, .max_node_size = 4096, .large_threshold = 2048 };
+  TEST_ASSERT_TRUE(arena_set_growth(arena, growth) == 0);
+  // Next node is min_node_size, so both fit in it back to back
+  char *first = arena_alloc_aligned(arena, 600, 1);
+  char *second = arena_alloc_aligned(arena, 400, 1);
+  TEST_ASSERT_TRUE(second == first + 600);
+  // Above the threshold, so doesn't disturb the node
+  TEST_ASSERT_NOT_NULL(arena_alloc_aligned(arena, 3000, 1));
+  TEST_ASSERT_TRUE(arena_alloc_aligned(arena, 8, 1) == second + 400);
+  arena_free(arena);
+}
+
+void test_arena_rewind_reuses_large() {
+  c_arena_t *arena = arena_create_flags(256, ARENA_GROWABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  char *before = arena_alloc(arena, 64 * 1024);
+  memset(before, 0xAB, 64 * 1024);
+  c_arena_mark_t mark = arena_mark(arena);
+  TEST_ASSERT_NOT_NULL(arena_alloc(arena, 64 * 1024));
+  TEST_ASSERT_NOT_NULL(arena_alloc(arena, 128 * 1024));
+  size_t grows = arena_stats(arena).grow_count;
+  arena_rewind(arena, mark);
+  TEST_ASSERT_TRUE((unsigned char)before[64 * 1024 - 1] == 0xAB);
+
+  // The rewound nodes serve the same requests again
+  TEST_ASSERT_NOT_NULL(arena_alloc(arena, 128 * 1024));
+  TEST_ASSERT_NOT_NULL(arena_alloc(arena, 64 * 1024));
+  TEST_ASSERT_EQUAL_UINT64(grows, arena_stats(arena).grow_count);
+  TEST_ASSERT_EQUAL_UINT64(4, arena_stats(arena).node_count);
+
+  // Including across a reset
+  arena_reset(arena);
+  TEST_ASSERT_NOT_NULL(arena_alloc(arena, 64 * 1024));
+  TEST_ASSERT_EQUAL_UINT64(grows, arena_stats(arena).grow_count);
+  TEST_ASSERT_EQUAL_UINT64(4, arena_stats(arena).node_count);
+  arena_free(arena);
+}
+
+void test_arena_stats() {
+  c_arena_t *arena = arena_create_flags(64, ARENA_GROWABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  c_arena_stats_t stats = arena_stats(arena);
+  TEST_ASSERT_TRUE(stats.node_count == 1);
+  TEST_ASSERT_TRUE(stats.reserved == 64);
+  TEST_ASSERT_TRUE(stats.committed == 64);
+  TEST_ASSERT_TRUE(stats.used == 0);
+  TEST_ASSERT_TRUE(stats.alloc_count == 0);
+
+  arena_alloc_aligned(arena, 1, 1);
+  arena_alloc_aligned(arena, 8, 8);
+  stats = arena_stats(arena);
+  TEST_ASSERT_TRUE(stats.alloc_count == 2);
+  TEST_ASSERT_TRUE(stats.padding == 7);
+  TEST_ASSERT_TRUE(stats.used == 16);
+
+  // Moves to a new 128 byte node, stranding the rest of the first
+  arena_alloc_aligned(arena, 100, 1);
+  stats = arena_stats(arena);
+  TEST_ASSERT_TRUE(stats.node_count == 2);
+  TEST_ASSERT_TRUE(stats.grow_count == 1);
+  TEST_ASSERT_TRUE(stats.stranded == 48);
+  TEST_ASSERT_TRUE(stats.reserved == 64 + 128);
+  TEST_ASSERT_TRUE(stats.used == 64 + 100);
+
+  arena_reset(arena);
+  stats = arena_stats(arena);
+  TEST_ASSERT_TRUE(stats.used == 0);
+  TEST_ASSERT_TRUE(stats.high_water == 64 + 100);
+  TEST_ASSERT_TRUE(stats.alloc_count == 3);
+  arena_free(arena);
+}
+
+void test_arena_stats_virtual() {
+  c_arena_t *arena = arena_create_flags(16 * 1024 * 1024, ARENA_VIRTUAL);
+  TEST_ASSERT_NOT_NULL(arena);
+  TEST_ASSERT_TRUE(arena_stats(arena).committed == 0);
+  arena_alloc(arena, 100);
+  c_arena_stats_t stats = arena_stats(arena);
+  TEST_ASSERT_TRUE(stats.reserved == 16 * 1024 * 1024);
+  TEST_ASSERT_TRUE(stats.committed > 0 && stats.committed < stats.reserved);
+  arena_free(arena);
+}
+
+typedef struct {
+  int counts[ARENA_EVENT_FREE + 1];
+  void *last_alloc;
+} event_log_t;
+
+static void count_events(c_arena_t *arena, const c_arena_event_t *event, void *ctx) {
+  (void)arena;
+  event_log_t *log = (event_log_t *)ctx;
+  log->counts[event->kind]++;
+  if (event->kind == ARENA_EVENT_ALLOC) log->last_alloc = event->ptr;
+}
+
+void test_arena_hook() {
+  event_log_t log = {0};
+  c_arena_t *arena = arena_create_flags(64, ARENA_GROWABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  arena_set_hook(arena, count_events, &log);
+  void *ptr = arena_alloc(arena, 16);
+  TEST_ASSERT_TRUE(log.counts[ARENA_EVENT_ALLOC] == 1);
+  TEST_ASSERT_TRUE(log.last_alloc == ptr);
+  arena_alloc(arena, 100);
+  TEST_ASSERT_TRUE(log.counts[ARENA_EVENT_ALLOC] == 2);
+  TEST_ASSERT_TRUE(log.counts[ARENA_EVENT_GROW] == 1);
+  arena_reset(arena);
+  TEST_ASSERT_TRUE(log.counts[ARENA_EVENT_RESET] == 1);
+  // Removing the hook goes back to the fast path, unobserved
+  arena_set_hook(arena, NULL, NULL);
+  arena_alloc(arena, 16);
+  TEST_ASSERT_TRUE(log.counts[ARENA_EVENT_ALLOC] == 2);
+  arena_set_hook(arena, count_events, &log);
+  arena_free(arena);
+  TEST_ASSERT_TRUE(log.counts[ARENA_EVENT_FREE] == 1);
+}
+
+void test_arena_default_hook() {
+  event_log_t log = {0};
+  arena_set_default_hook(count_events, &log);
+  c_arena_t *arena = arena_create(64);
+  arena_set_default_hook(NULL, NULL);
+  TEST_ASSERT_NOT_NULL(arena);
+  TEST_ASSERT_TRUE(log.counts[ARENA_EVENT_CREATE] == 1);
+  arena_alloc(arena, 16);
+  TEST_ASSERT_TRUE(log.counts[ARENA_EVENT_ALLOC] == 1);
+  arena_free(arena);
+  TEST_ASSERT_TRUE(log.counts[ARENA_EVENT_FREE] == 1);
+}
+
+void test_arena_rewind() {
+  c_arena_t *arena = arena_create_flags(256, ARENA_NO_FLAGS);
+  TEST_ASSERT_NOT_NULL(arena);
+  char *keep = arena_alloc(arena, 16);
+  TEST_ASSERT_NOT_NULL(keep);
+  c_arena_mark_t outer = arena_mark(arena);
+  char *scratch1 = arena_alloc(arena, 32);
+  TEST_ASSERT_NOT_NULL(scratch1);
+  c_arena_mark_t inner = arena_mark(arena);
+  char *scratch2 = arena_alloc(arena, 32);
+  TEST_ASSERT_NOT_NULL(scratch2);
+  arena_rewind(arena, inner);
+  TEST_ASSERT_TRUE(arena_alloc(arena, 32) == scratch2);
+  arena_rewind(arena, outer);
+  TEST_ASSERT_TRUE(arena_alloc(arena, 32) == scratch1);
+  arena_free(arena);
+}
+
+void test_arena_rewind_across_nodes() {
+  c_arena_t *arena = arena_create_flags(64, ARENA_GROWABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  char *keep = arena_alloc(arena, 16);
+  strncpy(keep, "keep me", 16);
+  c_arena_mark_t mark = arena_mark(arena);
+  char *after_mark = arena_alloc(arena, 16);
+  // Forces the arena into several new nodes
+  for (int i = 0; i < 8; i++) {
+    TEST_ASSERT_NOT_NULL(arena_alloc(arena, 64));
+  }
+  arena_rewind(arena, mark);
+  TEST_ASSERT_TRUE(strcmp(keep, "keep me") == 0);
+  TEST_ASSERT_TRUE(arena_alloc(arena, 16) == after_mark);
+  // Grown nodes are reused rather than chaining new ones
+  for (int i = 0; i < 8; i++) {
+    TEST_ASSERT_NOT_NULL(arena_alloc(arena, 64));
+  }
+  arena_free(arena);
+}
+
 int main(void) {
   UNITY_BEGIN();
   RUN_TEST(test_arena_alloc);
@@ -95,8 +777,43 @@ int main(void) {
   RUN_TEST(test_arena_alloc_aligned_8);
   RUN_TEST(test_arena_create);
   RUN_TEST(test_arena_reset);
+  RUN_TEST(test_arena_reset_zero_after_rewind);
+  RUN_TEST(test_arena_reset_keep);
+  RUN_TEST(test_arena_reset_release);
+  RUN_TEST(test_arena_reset_retain);
+  RUN_TEST(test_arena_reset_retain_decayed);
+  RUN_TEST(test_arena_reset_retain_virtual);
+  RUN_TEST(test_arena_realloc_in_place);
+  RUN_TEST(test_arena_realloc_shrink_zeroed);
+  RUN_TEST(test_arena_realloc_moves);
+  RUN_TEST(test_arena_realloc_virtual);
   RUN_TEST(test_fail_when_full);
   RUN_TEST(test_integrity);
   RUN_TEST(test_arena_grow);
+  RUN_TEST(test_arena_alloc_invalid_align);
+  RUN_TEST(test_arena_grow_many_nodes);
+  RUN_TEST(test_arena_virtual);
+  RUN_TEST(test_arena_large_alloc_keeps_node);
+  RUN_TEST(test_arena_growth_schedule);
+  RUN_TEST(test_arena_rewind_reuses_large);
+  RUN_TEST(test_arena_stats);
+  RUN_TEST(test_arena_stats_virtual);
+  RUN_TEST(test_arena_hook);
+  RUN_TEST(test_arena_default_hook);
+  RUN_TEST(test_arena_rewind);
+  RUN_TEST(test_arena_rewind_across_nodes);
+  RUN_TEST(test_arena_virtual_exhausted);
+  RUN_TEST(test_arena_huge_pages);
+  RUN_TEST(test_arena_hugetlb_falls_back);
+  RUN_TEST(test_arena_huge_pages_virtual);
+  RUN_TEST(test_arena_defer_reset);
+  RUN_TEST(test_arena_defer_free);
+  RUN_TEST(test_arena_defer_rewind);
+  RUN_TEST(test_arena_alloc_array);
+  RUN_TEST(test_arena_alloc_many);
+  RUN_TEST(test_arena_relptr);
+  RUN_TEST(test_arena_save_load);
+  RUN_TEST(test_arena_save_requires_relocatable);
+  RUN_TEST(test_arena_adaptive);
   return UNITY_END();
 }
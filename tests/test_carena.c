@@ -0,0 +1,119 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include "unity/src/unity.h"
+#include "../include/collections/carena.h"
+
+#define THREADS 8
+#define ALLOCS_PER_THREAD 10000
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_carena_create() {
+  c_carena_t *arena = carena_create(1024 * 1024, 4096);
+  TEST_ASSERT_NOT_NULL(arena);
+  carena_free(arena);
+}
+
+void test_carena_alloc_aligned() {
+  c_carena_t *arena = carena_create(1024 * 1024, 4096);
+  c_carena_lease_t lease = carena_lease_init(arena);
+  for (size_t align = 1; align <= 256; align *= 2) {
+    void *ptr = carena_alloc(&lease, 24, align);
+    TEST_ASSERT_NOT_NULL(ptr);
+    TEST_ASSERT_TRUE((uintptr_t)ptr % align == 0);
+  }
+  TEST_ASSERT_NULL(carena_alloc(&lease, 8, 3));
+  carena_free(arena);
+}
+
+void test_carena_large_alloc_keeps_lease() {
+  c_carena_t *arena = carena_create(1024 * 1024, 4096);
+  c_carena_lease_t lease = carena_lease_init(arena);
+  char *small1 = carena_alloc(&lease, 16, 16);
+  char *large = carena_alloc(&lease, 64 * 1024, 16);
+  TEST_ASSERT_NOT_NULL(large);
+  memset(large, 0xAB, 64 * 1024);
+  char *small2 = carena_alloc(&lease, 16, 16);
+  TEST_ASSERT_TRUE(small2 == small1 + 16);
+  carena_free(arena);
+}
+
+void test_carena_exhausted() {
+  c_carena_t *arena = carena_create(8192, 4096);
+  c_carena_lease_t lease = carena_lease_init(arena);
+  TEST_ASSERT_NOT_NULL(carena_alloc(&lease, 4000, 8));
+  TEST_ASSERT_NOT_NULL(carena_alloc(&lease, 4000, 8));
+  TEST_ASSERT_NULL(carena_alloc(&lease, 4000, 8));
+  carena_reset(arena);
+  lease = carena_lease_init(arena);
+  TEST_ASSERT_NOT_NULL(carena_alloc(&lease, 4000, 8));
+  carena_free(arena);
+}
+
+void test_carena_oversized_fails() {
+  c_carena_t *arena = carena_create(1024 * 1024, 4096);
+  c_carena_lease_t lease = carena_lease_init(arena);
+  // Would wrap around to a tiny request without the overflow check
+  TEST_ASSERT_NULL(carena_alloc(&lease, SIZE_MAX - 10, 1));
+  TEST_ASSERT_NULL(carena_alloc(&lease, SIZE_MAX - 10, 4096));
+  TEST_ASSERT_NULL(carena_alloc(&lease, 2 * 1024 * 1024, 8));
+  TEST_ASSERT_EQUAL_UINT64(0, carena_used(arena));
+  // Failed requests don't consume the arena
+  char *first = carena_alloc(&lease, 16, 8);
+  char *second = carena_alloc(&lease, 16, 8);
+  TEST_ASSERT_NOT_NULL(first);
+  TEST_ASSERT_NOT_NULL(second);
+  TEST_ASSERT_TRUE(first != second);
+  TEST_ASSERT_NOT_NULL(carena_alloc(&lease, 512 * 1024, 8));
+  carena_free(arena);
+}
+
+typedef struct {
+  c_carena_t *arena;
+  uint64_t *blocks[ALLOCS_PER_THREAD];
+  uint64_t id;
+} worker_t;
+
+static void *worker(void *arg) {
+  worker_t *w = (worker_t *)arg;
+  c_carena_lease_t lease = carena_lease_init(w->arena);
+  for (int i = 0; i < ALLOCS_PER_THREAD; i++) {
+    w->blocks[i] = carena_alloc(&lease, sizeof(uint64_t) * 4, alignof(uint64_t));
+    if (w->blocks[i] == NULL) return NULL;
+    for (int j = 0; j < 4; j++) w->blocks[i][j] = w->id;
+  }
+  return NULL;
+}
+
+void test_carena_threads_do_not_overlap() {
+  c_carena_t *arena = carena_create(64 * 1024 * 1024, 1024);
+  static worker_t workers[THREADS];
+  pthread_t threads[THREADS];
+  for (uint64_t i = 0; i < THREADS; i++) {
+    workers[i].arena = arena;
+    workers[i].id = i;
+    TEST_ASSERT_TRUE(pthread_create(&threads[i], NULL, worker, &workers[i]) == 0);
+  }
+  for (int i = 0; i < THREADS; i++) pthread_join(threads[i], NULL);
+  for (uint64_t i = 0; i < THREADS; i++) {
+    for (int j = 0; j < ALLOCS_PER_THREAD; j++) {
+      TEST_ASSERT_NOT_NULL(workers[i].blocks[j]);
+      for (int k = 0; k < 4; k++) TEST_ASSERT_TRUE(workers[i].blocks[j][k] == i);
+    }
+  }
+  TEST_ASSERT_TRUE(carena_used(arena) >= THREADS * ALLOCS_PER_THREAD * sizeof(uint64_t) * 4);
+  carena_free(arena);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_carena_create);
+  RUN_TEST(test_carena_alloc_aligned);
+  RUN_TEST(test_carena_large_alloc_keeps_lease);
+  RUN_TEST(test_carena_exhausted);
+  RUN_TEST(test_carena_oversized_fails);
+  RUN_TEST(test_carena_threads_do_not_overlap);
+  return UNITY_END();
+}
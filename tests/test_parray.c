@@ -1,4 +1,5 @@
 #include "../include/collections/parray.h"
+#include "../include/collections/arena.h"
 #include "unity/src/unity.h"
 #include <string.h>
 
@@ -110,6 +111,108 @@ void test_parray_pop_oob() {
   parray_free(parray);
 }
 
+static int counting_allocs = 0;
+static int counting_reallocs = 0;
+static size_t last_realloc_size = 0;
+
+static void *counting_alloc(void *ctx, size_t size) {
+  (void)ctx;
+  counting_allocs++;
+  return malloc(size);
+}
+
+static void *counting_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size) {
+  (void)ctx;
+  (void)old_size;
+  counting_allocs++;
+  counting_reallocs++;
+  last_realloc_size = new_size;
+  return realloc(ptr, new_size);
+}
+
+static void counting_free(void *ctx, void *ptr, size_t size) {
+  (void)ctx;
+  (void)size;
+  counting_allocs--;
+  free(ptr);
+}
+
+void test_parray_custom_allocator() {
+  c_allocator_t allocator = {
+    .alloc = counting_alloc,
+    .realloc = counting_realloc,
+    .free = counting_free,
+  };
+  c_parray_t *parray = parray_create_with_allocator(NULL, &allocator);
+  TEST_ASSERT_NOT_NULL(parray);
+  int items[50];
+  for (int i = 0; i < 50; i++) {
+    TEST_ASSERT_TRUE(parray_append(parray, &items[i]) == 0);
+  }
+  TEST_ASSERT_TRUE(counting_allocs > 2);
+  parray_free(parray);
+}
+
+void test_parray_arena_allocator() {
+  c_arena_t *arena = arena_create_flags(256, ARENA_GROWABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  c_allocator_t allocator = arena_allocator(arena);
+  c_parray_t *parray = parray_create_with_allocator(NULL, &allocator);
+  TEST_ASSERT_NOT_NULL(parray);
+  int items[100];
+  for (int i = 0; i < 100; i++) {
+    items[i] = i;
+    TEST_ASSERT_TRUE(parray_insert(parray, 0, &items[i]) == 0);
+  }
+  for (int i = 0; i < 100; i++) {
+    TEST_ASSERT_TRUE(*(const int *)parray_get(parray, i) == 99 - i);
+  }
+  arena_free(arena);
+}
+
+void test_parray_growth_policy() {
+  c_allocator_t allocator = {
+    .alloc = counting_alloc,
+    .realloc = counting_realloc,
+    .free = counting_free,
+  };
+  int items[1000];
+  c_parray_t *parray = parray_create_with_allocator(NULL, &allocator);
+  counting_reallocs = 0;
+  for (int i = 0; i < 1000; i++) TEST_ASSERT_TRUE(parray_append(parray, &items[i]) == 0);
+  int default_reallocs = counting_reallocs;
+  parray_free(parray);
+
+  parray = parray_create_with_allocator(NULL, &allocator);
+  TEST_ASSERT_TRUE(parray_set_growth(parray, (c_growth_policy_t){ .factor = 0.5 }) == -1);
+  TEST_ASSERT_TRUE(parray_set_growth(parray, (c_growth_policy_t){ .factor = 2.0 }) == 0);
+  counting_reallocs = 0;
+  for (int i = 0; i < 1000; i++) TEST_ASSERT_TRUE(parray_append(parray, &items[i]) == 0);
+  // Doubling needs far fewer reallocations than the built-in schedule
+  TEST_ASSERT_TRUE(counting_reallocs < default_reallocs / 2);
+  for (int i = 0; i < 1000; i++) TEST_ASSERT_TRUE(parray_get(parray, i) == &items[i]);
+  parray_free(parray);
+}
+
+void test_parray_shrink_to_fit() {
+  c_allocator_t allocator = {
+    .alloc = counting_alloc,
+    .realloc = counting_realloc,
+    .free = counting_free,
+  };
+  int items[100];
+  c_parray_t *parray = parray_create_with_allocator(NULL, &allocator);
+  for (int i = 0; i < 100; i++) TEST_ASSERT_TRUE(parray_append(parray, &items[i]) == 0);
+  for (int i = 0; i < 90; i++) TEST_ASSERT_NOT_NULL(parray_pop(parray, parray_length(parray) - 1));
+  TEST_ASSERT_TRUE(parray_shrink_to_fit(parray) == 0);
+  TEST_ASSERT_TRUE(last_realloc_size == 10 * sizeof(void *));
+  for (int i = 0; i < 10; i++) TEST_ASSERT_TRUE(parray_get(parray, i) == &items[i]);
+  // Still grows again afterwards
+  TEST_ASSERT_TRUE(parray_append(parray, &items[10]) == 0);
+  TEST_ASSERT_TRUE(parray_get(parray, 10) == &items[10]);
+  parray_free(parray);
+}
+
 int main(void) {
   UNITY_BEGIN();
   RUN_TEST(test_parray_create);
@@ -120,5 +223,9 @@ int main(void) {
   RUN_TEST(test_parray_insert);
   RUN_TEST(test_parray_pop_oob);
   RUN_TEST(test_parray_pop);
+  RUN_TEST(test_parray_custom_allocator);
+  RUN_TEST(test_parray_arena_allocator);
+  RUN_TEST(test_parray_growth_policy);
+  RUN_TEST(test_parray_shrink_to_fit);
   return UNITY_END();
 }
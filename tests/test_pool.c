@@ -0,0 +1,85 @@
+#include <stdint.h>
+#include <string.h>
+#include "unity/src/unity.h"
+#include "../include/collections/pool.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_pool_create() {
+  c_arena_t *arena = arena_create_flags(4096, ARENA_GROWABLE);
+  c_pool_t *pool = pool_create(arena, 24);
+  TEST_ASSERT_NOT_NULL(pool);
+  TEST_ASSERT_TRUE(pool_obj_size(pool) == 24);
+  TEST_ASSERT_NULL(pool_create(arena, 0));
+  arena_free(arena);
+}
+
+void test_pool_alloc_distinct() {
+  c_arena_t *arena = arena_create_flags(4096, ARENA_GROWABLE);
+  c_pool_t *pool = pool_create(arena, sizeof(uint64_t) * 3);
+  uint64_t *objs[1000];
+  for (int i = 0; i < 1000; i++) {
+    objs[i] = pool_alloc(pool);
+    TEST_ASSERT_NOT_NULL(objs[i]);
+    TEST_ASSERT_TRUE((uintptr_t)objs[i] % alignof(uint64_t) == 0);
+    objs[i][0] = objs[i][1] = objs[i][2] = (uint64_t)i;
+  }
+  for (int i = 0; i < 1000; i++) {
+    TEST_ASSERT_TRUE(objs[i][0] == (uint64_t)i && objs[i][2] == (uint64_t)i);
+  }
+  arena_free(arena);
+}
+
+void test_pool_alignment() {
+  c_arena_t *arena = arena_create_flags(4096, ARENA_GROWABLE);
+  size_t sizes[] = { 1, 3, 8, 12, 16, 33, 100, 256, 1000 };
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    c_pool_t *pool = pool_create(arena, sizes[i]);
+    for (int j = 0; j < 20; j++) {
+      void *obj = pool_alloc(pool);
+      TEST_ASSERT_NOT_NULL(obj);
+      size_t expected = sizes[i] >= alignof(max_align_t) ? alignof(max_align_t) : sizeof(void *);
+      TEST_ASSERT_TRUE((uintptr_t)obj % expected == 0);
+      memset(obj, 0xAB, sizes[i]);
+    }
+  }
+  arena_free(arena);
+}
+
+void test_pool_release_recycles() {
+  c_arena_t *arena = arena_create_flags(4096, ARENA_GROWABLE);
+  c_pool_t *pool = pool_create(arena, 32);
+  void *a = pool_alloc(pool);
+  void *b = pool_alloc(pool);
+  pool_release(pool, a);
+  pool_release(pool, b);
+  pool_release(pool, NULL);
+  // Most recently released first
+  TEST_ASSERT_TRUE(pool_alloc(pool) == b);
+  TEST_ASSERT_TRUE(pool_alloc(pool) == a);
+  arena_free(arena);
+}
+
+void test_pool_bulk_release() {
+  c_arena_t *arena = arena_create_flags(64 * 1024, ARENA_NO_FLAGS);
+  c_arena_mark_t mark = arena_mark(arena);
+  for (int round = 0; round < 100; round++) {
+    c_pool_t *pool = pool_create(arena, 64);
+    TEST_ASSERT_NOT_NULL(pool);
+    for (int i = 0; i < 500; i++) TEST_ASSERT_NOT_NULL(pool_alloc(pool));
+    // Everything in the pool goes at once
+    arena_rewind(arena, mark);
+  }
+  arena_free(arena);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_pool_create);
+  RUN_TEST(test_pool_alloc_distinct);
+  RUN_TEST(test_pool_alignment);
+  RUN_TEST(test_pool_release_recycles);
+  RUN_TEST(test_pool_bulk_release);
+  return UNITY_END();
+}
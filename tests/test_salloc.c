@@ -0,0 +1,74 @@
+#include <stdint.h>
+#include <string.h>
+#include "unity/src/unity.h"
+#include "../include/collections/salloc.h"
+
+static c_arena_t *arena;
+
+void setUp(void) { arena = arena_create_flags(64 * 1024, ARENA_GROWABLE); }
+void tearDown(void) { arena_free(arena); }
+
+void test_salloc_create() {
+  TEST_ASSERT_NOT_NULL(salloc_create(arena));
+  TEST_ASSERT_NULL(salloc_create(NULL));
+}
+
+void test_salloc_alloc_sizes() {
+  c_salloc_t *salloc = salloc_create(arena);
+  for (size_t size = 1; size <= 3 * SALLOC_MAX_CLASS; size = size * 3 / 2 + 1) {
+    char *ptr = salloc_alloc(salloc, size);
+    TEST_ASSERT_NOT_NULL(ptr);
+    TEST_ASSERT_TRUE((uintptr_t)ptr % alignof(max_align_t) == 0);
+    TEST_ASSERT_TRUE(salloc_usable_size(ptr) >= size);
+    memset(ptr, 0xAB, size);
+  }
+}
+
+void test_salloc_free_reuses() {
+  c_salloc_t *salloc = salloc_create(arena);
+  void *a = salloc_alloc(salloc, 40);
+  salloc_free(salloc, a);
+  salloc_free(salloc, NULL);
+  // Same class, so same block
+  TEST_ASSERT_TRUE(salloc_alloc(salloc, 60) == a);
+  // Different class, so a different block
+  TEST_ASSERT_TRUE(salloc_alloc(salloc, 40) != a);
+}
+
+void test_salloc_realloc() {
+  c_salloc_t *salloc = salloc_create(arena);
+  TEST_ASSERT_NULL(salloc_realloc(salloc, salloc_alloc(salloc, 8), 0));
+  char *ptr = salloc_realloc(salloc, NULL, 20);
+  TEST_ASSERT_NOT_NULL(ptr);
+  strcpy(ptr, "hello world");
+  // Fits the 32 byte class still
+  TEST_ASSERT_TRUE(salloc_realloc(salloc, ptr, 30) == ptr);
+  char *grown = salloc_realloc(salloc, ptr, 5000);
+  TEST_ASSERT_NOT_NULL(grown);
+  TEST_ASSERT_TRUE(strcmp(grown, "hello world") == 0);
+  char *shrunk = salloc_realloc(salloc, grown, 12);
+  TEST_ASSERT_TRUE(strcmp(shrunk, "hello world") == 0);
+  TEST_ASSERT_TRUE(salloc_usable_size(shrunk) == 16);
+}
+
+void test_salloc_allocator() {
+  c_salloc_t *salloc = salloc_create(arena);
+  c_allocator_t allocator = salloc_allocator(salloc);
+  char *block = allocator.alloc(allocator.ctx, 24);
+  TEST_ASSERT_NOT_NULL(block);
+  strcpy(block, "hello");
+  char *grown = allocator.realloc(allocator.ctx, block, 24, 200);
+  TEST_ASSERT_TRUE(strcmp(grown, "hello") == 0);
+  allocator.free(allocator.ctx, grown, 200);
+  TEST_ASSERT_TRUE(allocator.alloc(allocator.ctx, 200) == grown);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_salloc_create);
+  RUN_TEST(test_salloc_alloc_sizes);
+  RUN_TEST(test_salloc_free_reuses);
+  RUN_TEST(test_salloc_realloc);
+  RUN_TEST(test_salloc_allocator);
+  return UNITY_END();
+}
@@ -0,0 +1,115 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include "unity/src/unity.h"
+#include "../include/collections/scratch.h"
+
+void setUp(void) {}
+void tearDown(void) { scratch_thread_free(); }
+
+void test_scratch_begin() {
+  c_scratch_t scratch = scratch_begin(NULL, 0);
+  TEST_ASSERT_NOT_NULL(scratch.arena);
+  TEST_ASSERT_NOT_NULL(arena_alloc(scratch.arena, 128));
+  scratch_end(scratch);
+}
+
+void test_scratch_reuses_memory() {
+  c_scratch_t scratch1 = scratch_begin(NULL, 0);
+  void *ptr1 = arena_alloc(scratch1.arena, 128);
+  scratch_end(scratch1);
+  c_scratch_t scratch2 = scratch_begin(NULL, 0);
+  TEST_ASSERT_TRUE(scratch2.arena == scratch1.arena);
+  TEST_ASSERT_TRUE(arena_alloc(scratch2.arena, 128) == ptr1);
+  scratch_end(scratch2);
+}
+
+void test_scratch_avoids_conflicts() {
+  c_scratch_t outer = scratch_begin(NULL, 0);
+  TEST_ASSERT_NOT_NULL(outer.arena);
+  // A callee writing results into outer.arena needs scratch elsewhere
+  c_scratch_t inner = scratch_begin(&outer.arena, 1);
+  TEST_ASSERT_NOT_NULL(inner.arena);
+  TEST_ASSERT_TRUE(inner.arena != outer.arena);
+  scratch_end(inner);
+  scratch_end(outer);
+}
+
+void test_scratch_all_conflicting() {
+  c_scratch_t first = scratch_begin(NULL, 0);
+  c_scratch_t second = scratch_begin(&first.arena, 1);
+  c_arena_t *conflicts[] = { first.arena, second.arena };
+  c_scratch_t third = scratch_begin(conflicts, 2);
+  TEST_ASSERT_NULL(third.arena);
+  scratch_end(second);
+  scratch_end(first);
+}
+
+void test_scratch_nested_rewind() {
+  c_scratch_t outer = scratch_begin(NULL, 0);
+  char *kept = arena_alloc(outer.arena, 16);
+  strncpy(kept, "outer", 16);
+  c_scratch_t inner = scratch_begin(NULL, 0);
+  TEST_ASSERT_TRUE(inner.arena == outer.arena);
+  TEST_ASSERT_NOT_NULL(arena_alloc(inner.arena, 4096));
+  scratch_end(inner);
+  TEST_ASSERT_TRUE(strcmp(kept, "outer") == 0);
+  scratch_end(outer);
+}
+
+static void count_grows(c_arena_t *arena, const c_arena_event_t *event, void *ctx) {
+  (void)arena;
+  if (event->kind == ARENA_EVENT_GROW) (*(int *)ctx)++;
+}
+
+void test_scratch_steady_state() {
+  int grows = 0;
+  for (int i = 0; i < 5; i++) {
+    c_scratch_t scratch = scratch_begin(NULL, 0);
+    arena_set_hook(scratch.arena, count_grows, &grows);
+    TEST_ASSERT_NOT_NULL(arena_alloc(scratch.arena, 1024));
+    // Larger than the pool's arenas, so served by a dedicated node
+    TEST_ASSERT_NOT_NULL(arena_alloc(scratch.arena, 200 * 1024));
+    scratch_end(scratch);
+  }
+  // Only the first scope grows, later ones reuse its node
+  TEST_ASSERT_EQUAL_INT(1, grows);
+}
+
+static void count_frees(c_arena_t *arena, const c_arena_event_t *event, void *ctx) {
+  (void)arena;
+  if (event->kind == ARENA_EVENT_FREE) (*(int *)ctx)++;
+}
+
+static void *scratch_worker(void *arg) {
+  (void)arg;
+  c_scratch_t outer = scratch_begin(NULL, 0);
+  c_scratch_t inner = scratch_begin(&outer.arena, 1);
+  arena_alloc(inner.arena, 200 * 1024);
+  scratch_end(inner);
+  scratch_end(outer);
+  // Exits without calling scratch_thread_free
+  return NULL;
+}
+
+void test_scratch_freed_on_thread_exit() {
+  int frees = 0;
+  arena_set_default_hook(count_frees, &frees);
+  pthread_t thread;
+  TEST_ASSERT_TRUE(pthread_create(&thread, NULL, scratch_worker, NULL) == 0);
+  pthread_join(thread, NULL);
+  arena_set_default_hook(NULL, NULL);
+  TEST_ASSERT_EQUAL_INT(SCRATCH_POOL_COUNT, frees);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_scratch_begin);
+  RUN_TEST(test_scratch_reuses_memory);
+  RUN_TEST(test_scratch_avoids_conflicts);
+  RUN_TEST(test_scratch_all_conflicting);
+  RUN_TEST(test_scratch_nested_rewind);
+  RUN_TEST(test_scratch_steady_state);
+  RUN_TEST(test_scratch_freed_on_thread_exit);
+  return UNITY_END();
+}
@@ -0,0 +1,96 @@
+#include <stdint.h>
+#include <string.h>
+#include "unity/src/unity.h"
+#include "../include/collections/strbuf.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_strbuf_append() {
+  c_arena_t *arena = arena_create_flags(4096, ARENA_GROWABLE);
+  c_strbuf_t buf;
+  strbuf_init(&buf, arena);
+  TEST_ASSERT_TRUE(strbuf_append(&buf, "hello", 5));
+  TEST_ASSERT_TRUE(strbuf_append_char(&buf, ' '));
+  TEST_ASSERT_TRUE(strbuf_append_cstr(&buf, "world"));
+  TEST_ASSERT_TRUE(strbuf_appendf(&buf, " %d-%s", 42, "x"));
+  TEST_ASSERT_EQUAL_UINT64(16, strbuf_len(&buf));
+  c_str_t str = strbuf_finish(&buf);
+  TEST_ASSERT_EQUAL_UINT64(16, str.len);
+  TEST_ASSERT_EQUAL_STRING("hello world 42-x", str.ptr);
+  // Ready for the next string
+  TEST_ASSERT_EQUAL_UINT64(0, strbuf_len(&buf));
+  arena_free(arena);
+}
+
+void test_strbuf_grows_in_place() {
+  c_arena_t *arena = arena_create_flags(64 * 1024, ARENA_NO_FLAGS);
+  c_strbuf_t buf;
+  strbuf_init(&buf, arena);
+  TEST_ASSERT_TRUE(strbuf_append_char(&buf, 'a'));
+  const char *start = buf.data;
+  for (int i = 1; i < 10000; i++) TEST_ASSERT_TRUE(strbuf_append_char(&buf, 'a' + i % 26));
+  // Always the last allocation, so it never moved
+  TEST_ASSERT_TRUE(buf.data == start);
+  c_str_t str = strbuf_finish(&buf);
+  TEST_ASSERT_TRUE(str.ptr == start);
+  TEST_ASSERT_EQUAL_UINT64(10000, str.len);
+  TEST_ASSERT_EQUAL_INT('a' + 9999 % 26, str.ptr[9999]);
+  // The spare capacity was handed back
+  TEST_ASSERT_EQUAL_UINT64(10001, arena_stats(arena).used);
+  arena_free(arena);
+}
+
+void test_strbuf_moves_when_interleaved() {
+  c_arena_t *arena = arena_create_flags(4096, ARENA_GROWABLE);
+  c_strbuf_t buf;
+  strbuf_init(&buf, arena);
+  TEST_ASSERT_TRUE(strbuf_append_cstr(&buf, "prefix"));
+  // Another allocation pins the buffer where it is
+  char *other = arena_alloc(arena, 8);
+  TEST_ASSERT_NOT_NULL(other);
+  for (int i = 0; i < 100; i++) TEST_ASSERT_TRUE(strbuf_append_cstr(&buf, "0123456789"));
+  c_str_t str = strbuf_finish(&buf);
+  TEST_ASSERT_EQUAL_UINT64(1006, str.len);
+  TEST_ASSERT_EQUAL_MEMORY("prefix0123456789", str.ptr, 16);
+  TEST_ASSERT_EQUAL_INT('\0', str.ptr[str.len]);
+  arena_free(arena);
+}
+
+void test_strbuf_appendf_long() {
+  c_arena_t *arena = arena_create_flags(4096, ARENA_GROWABLE);
+  c_strbuf_t buf;
+  strbuf_init(&buf, arena);
+  char big[300];
+  memset(big, 'z', sizeof(big) - 1);
+  big[sizeof(big) - 1] = '\0';
+  // Longer than the initial capacity, so formats twice
+  TEST_ASSERT_TRUE(strbuf_appendf(&buf, "<%s>", big));
+  c_str_t str = strbuf_finish(&buf);
+  TEST_ASSERT_EQUAL_UINT64(301, str.len);
+  TEST_ASSERT_EQUAL_INT('<', str.ptr[0]);
+  TEST_ASSERT_EQUAL_INT('z', str.ptr[299]);
+  TEST_ASSERT_EQUAL_INT('>', str.ptr[300]);
+  arena_free(arena);
+}
+
+void test_strbuf_finish_empty() {
+  c_arena_t *arena = arena_create_flags(4096, ARENA_GROWABLE);
+  c_strbuf_t buf;
+  strbuf_init(&buf, arena);
+  c_str_t str = strbuf_finish(&buf);
+  TEST_ASSERT_NOT_NULL(str.ptr);
+  TEST_ASSERT_EQUAL_UINT64(0, str.len);
+  TEST_ASSERT_EQUAL_STRING("", str.ptr);
+  arena_free(arena);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_strbuf_append);
+  RUN_TEST(test_strbuf_grows_in_place);
+  RUN_TEST(test_strbuf_moves_when_interleaved);
+  RUN_TEST(test_strbuf_appendf_long);
+  RUN_TEST(test_strbuf_finish_empty);
+  return UNITY_END();
+}
@@ -0,0 +1,73 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "unity/src/unity.h"
+#include "../include/collections/strintern.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_strintern_dedup() {
+  c_arena_t *arena = arena_create_flags(4096, ARENA_GROWABLE);
+  c_strintern_t *interner = strintern_create(arena);
+  TEST_ASSERT_NOT_NULL(interner);
+  uint32_t foo = strintern_intern(interner, "foo", 3);
+  uint32_t bar = strintern_intern(interner, "bar", 3);
+  TEST_ASSERT_EQUAL_UINT32(0, foo);
+  TEST_ASSERT_EQUAL_UINT32(1, bar);
+  // Not NUL terminated input, matched by length
+  TEST_ASSERT_EQUAL_UINT32(foo, strintern_intern(interner, "foobar", 3));
+  TEST_ASSERT_EQUAL_UINT64(2, strintern_count(interner));
+  c_str_t str = strintern_get(interner, bar);
+  TEST_ASSERT_EQUAL_UINT64(3, str.len);
+  TEST_ASSERT_EQUAL_STRING("bar", str.ptr);
+  TEST_ASSERT_NULL(strintern_get(interner, 2).ptr);
+  strintern_free(interner);
+  arena_free(arena);
+}
+
+void test_strintern_lookup() {
+  c_arena_t *arena = arena_create_flags(4096, ARENA_GROWABLE);
+  c_strintern_t *interner = strintern_create(arena);
+  TEST_ASSERT_EQUAL_UINT32(STRINTERN_INVALID, strintern_lookup(interner, "foo", 3));
+  uint32_t id = strintern_intern(interner, "foo", 3);
+  TEST_ASSERT_EQUAL_UINT32(id, strintern_lookup(interner, "foo", 3));
+  // Prefixes and the empty string are distinct strings
+  TEST_ASSERT_EQUAL_UINT32(STRINTERN_INVALID, strintern_lookup(interner, "fo", 2));
+  uint32_t empty = strintern_intern(interner, "", 0);
+  TEST_ASSERT_TRUE(empty != id);
+  TEST_ASSERT_EQUAL_STRING("", strintern_get(interner, empty).ptr);
+  strintern_free(interner);
+  arena_free(arena);
+}
+
+void test_strintern_many() {
+  c_arena_t *arena = arena_create_flags(4096, ARENA_GROWABLE);
+  c_strintern_t *interner = strintern_create(arena);
+  char name[64];
+  const char *first = NULL;
+  // Grows the table many times over, with strings of every hashing length class
+  for (int i = 0; i < 20000; i++) {
+    int len = snprintf(name, sizeof(name), "identifier_%d_%.*s", i, i % 40, "abcdefghijklmnopqrstuvwxyzabcdefghijklmn");
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)i, strintern_intern(interner, name, (size_t)len));
+    if (i == 0) first = strintern_get(interner, 0).ptr;
+  }
+  TEST_ASSERT_EQUAL_UINT64(20000, strintern_count(interner));
+  for (int i = 0; i < 20000; i++) {
+    int len = snprintf(name, sizeof(name), "identifier_%d_%.*s", i, i % 40, "abcdefghijklmnopqrstuvwxyzabcdefghijklmn");
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)i, strintern_intern(interner, name, (size_t)len));
+    TEST_ASSERT_EQUAL_STRING(name, strintern_get(interner, (uint32_t)i).ptr);
+  }
+  // Strings never move
+  TEST_ASSERT_TRUE(strintern_get(interner, 0).ptr == first);
+  strintern_free(interner);
+  arena_free(arena);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_strintern_dedup);
+  RUN_TEST(test_strintern_lookup);
+  RUN_TEST(test_strintern_many);
+  return UNITY_END();
+}
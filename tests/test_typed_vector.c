@@ -0,0 +1,84 @@
+#include <stdint.h>
+#include <string.h>
+#include "unity/src/unity.h"
+#include "../include/collections/typed_vector.h"
+#include "../include/collections/arena.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+typedef struct {
+  double x;
+  double y;
+} point;
+
+VECTOR_DECLARE(int32_t, i32)
+VECTOR_DECLARE(point, point)
+
+void test_typed_vector_push_get() {
+  c_vector_i32_t v;
+  vector_i32_init(&v, NULL);
+  TEST_ASSERT_EQUAL_UINT64(0, vector_i32_size(&v));
+  for (int32_t i = 0; i < 1000; i++) TEST_ASSERT_EQUAL_INT(0, vector_i32_push(&v, i * 3));
+  TEST_ASSERT_EQUAL_UINT64(1000, vector_i32_size(&v));
+  for (int32_t i = 0; i < 1000; i++) {
+    int32_t out = 0;
+    TEST_ASSERT_EQUAL_INT(0, vector_i32_get(&v, (size_t)i, &out));
+    TEST_ASSERT_EQUAL_INT32(i * 3, out);
+  }
+  int32_t out = 0;
+  TEST_ASSERT_EQUAL_INT(-1, vector_i32_get(&v, 1000, &out));
+  vector_i32_free(&v);
+}
+
+void test_typed_vector_set_pop() {
+  c_vector_point_t v;
+  vector_point_init(&v, NULL);
+  TEST_ASSERT_EQUAL_INT(-1, vector_point_set(&v, 0, (point){ 1, 2 }));
+  TEST_ASSERT_EQUAL_INT(0, vector_point_push(&v, (point){ 1, 2 }));
+  TEST_ASSERT_EQUAL_INT(0, vector_point_push(&v, (point){ 3, 4 }));
+  TEST_ASSERT_EQUAL_INT(0, vector_point_set(&v, 0, (point){ 5, 6 }));
+  TEST_ASSERT_TRUE(v.data[0].x == 5 && v.data[0].y == 6);
+  point out = { 0, 0 };
+  TEST_ASSERT_EQUAL_INT(0, vector_point_pop(&v, &out));
+  TEST_ASSERT_TRUE(out.x == 3 && out.y == 4);
+  TEST_ASSERT_EQUAL_INT(0, vector_point_pop(&v, NULL));
+  TEST_ASSERT_EQUAL_INT(-1, vector_point_pop(&v, &out));
+  vector_point_free(&v);
+}
+
+void test_typed_vector_shares_growth() {
+  c_vector_i32_t typed;
+  vector_i32_init(&typed, NULL);
+  c_vector_t *generic = vector_create(sizeof(int32_t));
+  for (int32_t i = 0; i < 500; i++) {
+    vector_i32_push(&typed, i);
+    vector_push_back(generic, &i);
+    // The typed vector starts empty, but follows the same schedule once it has grown
+    if (typed.capacity >= vector_capacity(generic)) {
+      TEST_ASSERT_EQUAL_UINT64(vector_capacity(generic), typed.capacity);
+    }
+  }
+  vector_free(generic);
+  vector_i32_free(&typed);
+}
+
+void test_typed_vector_allocator() {
+  c_arena_t *arena = arena_create_flags(4096, ARENA_GROWABLE);
+  c_allocator_t allocator = arena_allocator(arena);
+  c_vector_i32_t v;
+  vector_i32_init(&v, &allocator);
+  for (int32_t i = 0; i < 100; i++) TEST_ASSERT_EQUAL_INT(0, vector_i32_push(&v, i));
+  TEST_ASSERT_EQUAL_INT32(99, v.data[99]);
+  // Released along with the arena
+  arena_free(arena);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_typed_vector_push_get);
+  RUN_TEST(test_typed_vector_set_pop);
+  RUN_TEST(test_typed_vector_shares_growth);
+  RUN_TEST(test_typed_vector_allocator);
+  return UNITY_END();
+}
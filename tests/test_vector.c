@@ -1,5 +1,6 @@
 #include "unity/src/unity.h"
 #include "../../include/collections/vector.h"
+#include "../../include/collections/arena.h"
 #include <string.h>
 
 void setUp(void) {}
@@ -209,6 +210,212 @@ void test_vector_pop_back() {
   vector_free(v);
 }
 
+void test_vector_with_arena_allocator() {
+  c_arena_t *arena = arena_create_flags(1024, ARENA_GROWABLE);
+  TEST_ASSERT_NOT_NULL(arena);
+  c_allocator_t allocator = arena_allocator(arena);
+  c_vector_t *v = vector_create_with_allocator(sizeof(int), &allocator);
+  TEST_ASSERT_NOT_NULL(v);
+  for (int i = 0; i < 1000; i++) {
+    TEST_ASSERT_TRUE(vector_push_back(v, &i) == 0);
+  }
+  for (int i = 0; i < 1000; i++) {
+    int out;
+    TEST_ASSERT_TRUE(vector_get(v, i, &out) == 0);
+    TEST_ASSERT_TRUE(out == i);
+  }
+  // Vector dies with the arena, no vector_free needed
+  arena_free(arena);
+}
+
+void test_vector_at() {
+  c_vector_t *v = vector_create(sizeof(int));
+  TEST_ASSERT_NOT_NULL(v);
+  TEST_ASSERT_NULL(vector_at(v, 0));
+  TEST_ASSERT_NULL(vector_back(v));
+  for (int i = 0; i < 10; i++) {
+    TEST_ASSERT_TRUE(vector_push_back(v, &i) == 0);
+  }
+  int *data = vector_data(v);
+  TEST_ASSERT_NOT_NULL(data);
+  for (int i = 0; i < 10; i++) {
+    TEST_ASSERT_TRUE(vector_at(v, i) == &data[i]);
+    TEST_ASSERT_TRUE(data[i] == i);
+  }
+  TEST_ASSERT_NULL(vector_at(v, 10));
+  TEST_ASSERT_TRUE(*(int *)vector_back(v) == 9);
+  // Writes through the pointer are visible to the vector
+  *(int *)vector_at(v, 3) = 42;
+  int out;
+  TEST_ASSERT_TRUE(vector_get(v, 3, &out) == 0);
+  TEST_ASSERT_TRUE(out == 42);
+  vector_free(v);
+}
+
+void test_vector_emplace_back() {
+  typedef struct { int id; char name[60]; } record;
+  c_vector_t *v = vector_create(sizeof(record));
+  TEST_ASSERT_NOT_NULL(v);
+  for (int i = 0; i < 100; i++) {
+    record *r = vector_emplace_back(v);
+    TEST_ASSERT_NOT_NULL(r);
+    r->id = i;
+    r->name[0] = (char)('a' + i % 26);
+  }
+  TEST_ASSERT_TRUE(vector_size(v) == 100);
+  for (int i = 0; i < 100; i++) {
+    record *r = vector_at(v, i);
+    TEST_ASSERT_TRUE(r->id == i);
+    TEST_ASSERT_TRUE(r->name[0] == 'a' + i % 26);
+  }
+  TEST_ASSERT_TRUE(((record *)vector_back(v))->id == 99);
+  vector_free(v);
+}
+
+void test_vector_append_n() {
+  c_vector_t *v = vector_create(sizeof(int));
+  TEST_ASSERT_NOT_NULL(v);
+  int values[1000];
+  for (int i = 0; i < 1000; i++) values[i] = i;
+  TEST_ASSERT_TRUE(vector_append_n(v, values, 10) == 0);
+  TEST_ASSERT_TRUE(vector_append_n(v, values + 10, 990) == 0);
+  TEST_ASSERT_TRUE(vector_append_n(v, values, 0) == 0);
+  TEST_ASSERT_TRUE(vector_size(v) == 1000);
+  TEST_ASSERT_TRUE(vector_capacity(v) >= 1000);
+  TEST_ASSERT_EQUAL_MEMORY(values, vector_data(v), sizeof(values));
+  vector_free(v);
+}
+
+void test_vector_insert_range() {
+  c_vector_t *v = vector_create(sizeof(int));
+  TEST_ASSERT_NOT_NULL(v);
+  int outer[] = {0, 1, 5, 6};
+  int inner[] = {2, 3, 4};
+  TEST_ASSERT_TRUE(vector_append_n(v, outer, 4) == 0);
+  TEST_ASSERT_TRUE(vector_insert_range(v, 2, inner, 3) == 0);
+  int expected[] = {0, 1, 2, 3, 4, 5, 6};
+  TEST_ASSERT_TRUE(vector_size(v) == 7);
+  TEST_ASSERT_EQUAL_MEMORY(expected, vector_data(v), sizeof(expected));
+  // Past the end
+  TEST_ASSERT_TRUE(vector_insert_range(v, 8, inner, 3) == -1);
+  vector_free(v);
+}
+
+void test_vector_erase_range() {
+  c_vector_t *v = vector_create(sizeof(int));
+  TEST_ASSERT_NOT_NULL(v);
+  int values[] = {0, 1, 2, 3, 4, 5, 6};
+  TEST_ASSERT_TRUE(vector_append_n(v, values, 7) == 0);
+  TEST_ASSERT_TRUE(vector_erase_range(v, 1, 3) == 0);
+  int expected[] = {0, 4, 5, 6};
+  TEST_ASSERT_TRUE(vector_size(v) == 4);
+  TEST_ASSERT_EQUAL_MEMORY(expected, vector_data(v), sizeof(expected));
+  TEST_ASSERT_TRUE(vector_erase_range(v, 2, 3) == -1);
+  TEST_ASSERT_TRUE(vector_erase_range(v, 2, 2) == 0);
+  TEST_ASSERT_TRUE(vector_size(v) == 2);
+  vector_free(v);
+}
+
+void test_vector_assign() {
+  c_vector_t *v = vector_create(sizeof(int));
+  TEST_ASSERT_NOT_NULL(v);
+  int first[] = {9, 9, 9};
+  int second[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  TEST_ASSERT_TRUE(vector_assign(v, first, 3) == 0);
+  TEST_ASSERT_TRUE(vector_assign(v, second, 8) == 0);
+  TEST_ASSERT_TRUE(vector_size(v) == 8);
+  TEST_ASSERT_EQUAL_MEMORY(second, vector_data(v), sizeof(second));
+  TEST_ASSERT_TRUE(vector_assign(v, NULL, 0) == 0);
+  TEST_ASSERT_TRUE(vector_empty(v));
+  vector_free(v);
+}
+
+void test_vector_self_range() {
+  c_vector_t *v = vector_create(sizeof(int));
+  TEST_ASSERT_NOT_NULL(v);
+  int values[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  TEST_ASSERT_TRUE(vector_append_n(v, values, 10) == 0);
+  // Full, so appending itself has to grow first
+  TEST_ASSERT_TRUE(vector_shrink_to_fit(v) == 0);
+  TEST_ASSERT_TRUE(vector_append_n(v, vector_data(v), vector_size(v)) == 0);
+  TEST_ASSERT_TRUE(vector_size(v) == 20);
+  TEST_ASSERT_EQUAL_MEMORY(values, vector_data(v), sizeof(values));
+  TEST_ASSERT_EQUAL_MEMORY(values, vector_at(v, 10), sizeof(values));
+
+  // A source straddling the insertion point is split by the tail's move
+  TEST_ASSERT_TRUE(vector_assign(v, values, 6) == 0);
+  TEST_ASSERT_TRUE(vector_shrink_to_fit(v) == 0);
+  TEST_ASSERT_TRUE(vector_insert_range(v, 3, vector_at(v, 1), 4) == 0);
+  int straddled[] = {0, 1, 2, 1, 2, 3, 4, 3, 4, 5};
+  TEST_ASSERT_TRUE(vector_size(v) == 10);
+  TEST_ASSERT_EQUAL_MEMORY(straddled, vector_data(v), sizeof(straddled));
+
+  // Assigning a later part of itself overlaps
+  TEST_ASSERT_TRUE(vector_assign(v, vector_at(v, 2), 8) == 0);
+  TEST_ASSERT_TRUE(vector_size(v) == 8);
+  TEST_ASSERT_EQUAL_MEMORY(&straddled[2], vector_data(v), 8 * sizeof(int));
+  vector_free(v);
+}
+
+static size_t grow_by_one(size_t capacity, size_t required, void *ctx) {
+  (void)required;
+  (*(int *)ctx)++;
+  return capacity + 1;
+}
+
+void test_vector_growth_policy() {
+  c_vector_t *v = vector_create(sizeof(int));
+  TEST_ASSERT_NOT_NULL(v);
+  TEST_ASSERT_TRUE(vector_set_growth(v, (c_growth_policy_t){ .factor = 0.5 }) == -1);
+  TEST_ASSERT_TRUE(vector_set_growth(v, (c_growth_policy_t){ .factor = 2.0 }) == 0);
+  size_t capacity = vector_capacity(v);
+  for (int i = 0; i < 100; i++) {
+    TEST_ASSERT_TRUE(vector_push_back(v, &i) == 0);
+    if (vector_capacity(v) != capacity) {
+      TEST_ASSERT_TRUE(vector_capacity(v) == capacity * 2);
+      capacity = vector_capacity(v);
+    }
+  }
+
+  // A minimum step applies on top of the built-in schedule
+  TEST_ASSERT_TRUE(vector_set_growth(v, (c_growth_policy_t){ .min_step = 1000 }) == 0);
+  while (vector_size(v) < vector_capacity(v)) TEST_ASSERT_TRUE(vector_push_back(v, &capacity) == 0);
+  capacity = vector_capacity(v);
+  TEST_ASSERT_TRUE(vector_push_back(v, &capacity) == 0);
+  TEST_ASSERT_TRUE(vector_capacity(v) >= capacity + 1000);
+
+  int calls = 0;
+  TEST_ASSERT_TRUE(vector_set_growth(v, (c_growth_policy_t){ .custom = grow_by_one, .ctx = &calls }) == 0);
+  while (vector_size(v) < vector_capacity(v)) TEST_ASSERT_TRUE(vector_push_back(v, &capacity) == 0);
+  capacity = vector_capacity(v);
+  TEST_ASSERT_TRUE(vector_push_back(v, &capacity) == 0);
+  TEST_ASSERT_TRUE(vector_capacity(v) == capacity + 1);
+  TEST_ASSERT_TRUE(calls == 1);
+  // Bulk operations still get all they need at once
+  int values[50] = {0};
+  TEST_ASSERT_TRUE(vector_append_n(v, values, 50) == 0);
+  TEST_ASSERT_TRUE(vector_capacity(v) >= capacity + 51);
+  vector_free(v);
+}
+
+void test_vector_shrink_to_fit() {
+  c_vector_t *v = vector_create(sizeof(int));
+  TEST_ASSERT_NOT_NULL(v);
+  for (int i = 0; i < 1000; i++) TEST_ASSERT_TRUE(vector_push_back(v, &i) == 0);
+  TEST_ASSERT_TRUE(vector_erase_range(v, 10, 990) == 0);
+  TEST_ASSERT_TRUE(vector_shrink_to_fit(v) == 0);
+  TEST_ASSERT_TRUE(vector_capacity(v) == 10);
+  for (int i = 0; i < 10; i++) TEST_ASSERT_TRUE(*(int *)vector_at(v, i) == i);
+  TEST_ASSERT_TRUE(vector_erase_range(v, 0, 10) == 0);
+  TEST_ASSERT_TRUE(vector_shrink_to_fit(v) == 0);
+  TEST_ASSERT_TRUE(vector_capacity(v) == 1);
+  int value = 7;
+  TEST_ASSERT_TRUE(vector_push_back(v, &value) == 0);
+  TEST_ASSERT_TRUE(vector_push_back(v, &value) == 0);
+  TEST_ASSERT_TRUE(vector_size(v) == 2);
+  vector_free(v);
+}
+
 int main(void) {
   UNITY_BEGIN();
   RUN_TEST(test_vector_create);
@@ -224,5 +431,15 @@ int main(void) {
   RUN_TEST(test_vector_push_back);
   RUN_TEST(test_vector_pop_back_out_param);
   RUN_TEST(test_vector_pop_back);
+  RUN_TEST(test_vector_with_arena_allocator);
+  RUN_TEST(test_vector_at);
+  RUN_TEST(test_vector_emplace_back);
+  RUN_TEST(test_vector_append_n);
+  RUN_TEST(test_vector_insert_range);
+  RUN_TEST(test_vector_erase_range);
+  RUN_TEST(test_vector_assign);
+  RUN_TEST(test_vector_self_range);
+  RUN_TEST(test_vector_growth_policy);
+  RUN_TEST(test_vector_shrink_to_fit);
   return UNITY_END();
 }